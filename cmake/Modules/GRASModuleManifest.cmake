@@ -0,0 +1,20 @@
+########################################################################
+## Run the module manifest tool as a build step:
+## cmake -DGRAS_MODULE_MANIFEST_EXECUTABLE=<tool> -DMODULE=<module>
+##     -DMANIFEST=<manifest> -P GRASModuleManifest.cmake
+##
+## The module cache of the tool goes next to the manifest,
+## so that building a module never writes into the home directory,
+## and the search paths of the build environment are not indexed.
+########################################################################
+set(ENV{GRAS_MODULE_CACHE} ${MANIFEST}.cache)
+set(ENV{GRAS_PATH} "")
+set(ENV{GRAS_MODULE_PATH} "")
+
+execute_process(
+    COMMAND ${GRAS_MODULE_MANIFEST_EXECUTABLE} ${MODULE} ${MANIFEST}
+    RESULT_VARIABLE result
+)
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "Failed to write the manifest of ${MODULE}")
+endif()
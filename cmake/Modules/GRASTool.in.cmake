@@ -58,6 +58,20 @@ if (NOT GRAS_LIBRARIES)
     )
 endif()
 
+#locate the tool that writes module manifests
+set(GRAS_MODULE_MANIFEST_SCRIPT ${CMAKE_CURRENT_LIST_DIR}/GRASModuleManifest.cmake)
+if (NOT GRAS_MODULE_MANIFEST_EXECUTABLE)
+    if (TARGET gras_module_manifest)
+        set(GRAS_MODULE_MANIFEST_EXECUTABLE $<TARGET_FILE:gras_module_manifest>)
+    elseif (NOT CMAKE_CROSSCOMPILING)
+        find_program(
+            GRAS_MODULE_MANIFEST_EXECUTABLE
+            NAMES gras_module_manifest
+            PATHS ${GRAS_ROOT}/bin
+        )
+    endif()
+endif()
+
 ########################################################################
 ## GRAS_TOOL cmake function - the swiss army knife for GRAS users
 ##
@@ -142,6 +156,28 @@ function(GRAS_TOOL)
             RUNTIME DESTINATION ${GRAS_TOOL_MOD_DIR} COMPONENT ${GRAS_TOOL_COMPONENT} # .dll file
         )
 
+        #write a manifest of the factory paths that the module registers,
+        #so the module loader can load the module on demand
+        if (GRAS_MODULE_MANIFEST_EXECUTABLE)
+            set(manifest ${CMAKE_CURRENT_BINARY_DIR}/${CMAKE_SHARED_MODULE_PREFIX}${GRAS_TOOL_TARGET}${CMAKE_SHARED_MODULE_SUFFIX}.manifest)
+            add_custom_command(
+                TARGET ${GRAS_TOOL_TARGET} POST_BUILD
+                COMMAND ${CMAKE_COMMAND}
+                    -DGRAS_MODULE_MANIFEST_EXECUTABLE=${GRAS_MODULE_MANIFEST_EXECUTABLE}
+                    -DMODULE=$<TARGET_FILE:${GRAS_TOOL_TARGET}>
+                    -DMANIFEST=${manifest}
+                    -P ${GRAS_MODULE_MANIFEST_SCRIPT}
+            )
+            if (TARGET gras_module_manifest)
+                add_dependencies(${GRAS_TOOL_TARGET} gras_module_manifest)
+            endif()
+            install(
+                FILES ${manifest}
+                DESTINATION ${GRAS_TOOL_MOD_DIR}
+                COMPONENT ${GRAS_TOOL_COMPONENT}
+            )
+        endif()
+
         #export global variables for help locating build targets
         get_target_property(module_location ${GRAS_TOOL_TARGET} LOCATION)
         string(REGEX REPLACE "\\$\\(.*\\)" ${CMAKE_BUILD_TYPE} module_location ${module_location})
@@ -4,6 +4,8 @@
 #define INCLUDED_GRAS_BLOCK_HPP
 
 #include <gras/block_config.hpp>
+#include <gras/block_params.hpp>
+#include <gras/cancel_token.hpp>
 #include <gras/element.hpp>
 #include <gras/sbuffer.hpp>
 #include <gras/thread_pool.hpp>
@@ -11,6 +13,7 @@
 #include <gras/tags.hpp>
 #include <gras/work_buffer.hpp>
 #include <gras/buffer_queue.hpp>
+#include <gras/detail/msg_slot.hpp>
 #include <vector>
 #include <string>
 
@@ -76,12 +79,46 @@ struct GRAS_API Block : Element
      * Deal with tag handling and tag configuration
      ******************************************************************/
 
-    //! Send a tag to the downstream on the given output port
+    /*!
+     * Send a tag to the downstream on the given output port.
+     * Tags posted during work are batched together and delivered
+     * in the same message as the buffer of produced items.
+     * Tags posted outside of work are delivered right away.
+     * \param which_output the index of the output port
+     * \param tag the tag with an absolute item offset
+     */
     void post_output_tag(const size_t which_output, const Tag &tag);
 
     //! Get an iterator of item tags for the given input
     TagIter get_input_tags(const size_t which_input);
 
+    /*!
+     * Get an iterator of item tags in a range of absolute offsets.
+     * The range is [begin, end), where the offsets are absolute item counts.
+     * Example, tags in the current input buffer:
+     * get_input_tags(i, get_consumed(i), get_consumed(i)+input_items[i].size())
+     *
+     * \param which_input the input port index
+     * \param begin the first absolute offset (inclusive)
+     * \param end the last absolute offset (exclusive)
+     * \return an iterator of tags sorted by offset
+     */
+    TagIter get_input_tags(const size_t which_input, const item_index_t begin, const item_index_t end);
+
+    /*!
+     * Get the stream tags with a matching key on a given input port,
+     * with absolute offsets in the range [begin, end).
+     * Keys are compared by interned id, which is an integer compare.
+     * Make the TagKey once (say in the constructor) and reuse it.
+     *
+     * \param which_input the input port index
+     * \param key the interned stream tag key
+     * \param begin the first absolute offset (inclusive)
+     * \param end the last absolute offset (exclusive)
+     * \return an iterator of matching tags sorted by offset
+     */
+    KeyedTagIter get_input_tags(const size_t which_input, const TagKey &key, const item_index_t begin, const item_index_t end);
+
     /*!
      * Overload me to implement custom tag propagation logic:
      *
@@ -115,6 +152,12 @@ struct GRAS_API Block : Element
      * Send a message to the downstream on the given output port.
      * Messages are naturally asynchronous to stream and tag data.
      *
+     * Typed values are copied into a preallocated slot
+     * from a per-port pool, and are not boxed into a PMC.
+     * Consumers pop the value with the typed pop_input_msg(),
+     * or get the value boxed on demand with the PMC pop_input_msg().
+     * PMC and PMCC values are always passed as-is.
+     *
      * \param which_output the index of the output port
      * \param msg the message object to pass downstream
      */
@@ -138,6 +181,37 @@ struct GRAS_API Block : Element
      */
     PMCC pop_input_msg(const size_t which_input);
 
+    /*!
+     * Pop a typed message from the specified port.
+     * This is a non-blocking call, and will return false
+     * when no message is available or when the next message
+     * is not of type ValueType; the message is left on the queue.
+     * Ports with heterogeneous messages can try each type in turn,
+     * and then fall back to the PMC pop_input_msg().
+     *
+     * Messages that were posted as typed values are copied out
+     * of their slot, and PMC messages are unboxed with as<T>().
+     *
+     * \param which_input the index of the input port
+     * \param value the message value to fill in
+     * \return true when value was popped from the port
+     */
+    template <typename ValueType>
+    bool pop_input_msg(const size_t which_input, ValueType &value);
+
+    /*!
+     * Get a buffer for the payload of an output message,
+     * typically to fill in and post downstream as a PacketMsg.
+     * Buffers come from a per-port pool of power of two size classes.
+     * The buffer returns to the pool by itself once the last reference
+     * is gone, so a steady flow of packets does not touch the heap.
+     *
+     * \param which_output the output port index the message is posted on
+     * \param num_bytes the number of bytes needed for the payload
+     * \return a buffer with its length set to num_bytes
+     */
+    SBuffer get_output_msg_buffer(const size_t which_output, const size_t num_bytes);
+
     /*!
      * Send a message to the given input port on this block.
      * This is a thread-safe way for external scheduler
@@ -199,6 +273,45 @@ struct GRAS_API Block : Element
      */
     void mark_done(void);
 
+    /*!
+     * Get the cancel token for this block.
+     * The token is cancelled when the top block is stopped.
+     * A work routine that blocks (waiting on a device or socket)
+     * should use the token's interruptible waits or poll cancelled(),
+     * and return from work without producing when cancelled.
+     *
+     * \return a reference to the cancel token
+     */
+    const CancelToken &get_cancel_token(void) const;
+
+    /*******************************************************************
+     * Lock-free parameter API
+     ******************************************************************/
+
+    /*!
+     * Register block params under a name.
+     * The block latches the latest params before each work call,
+     * so work() reads them with params.get() and without messaging.
+     * Call this in the constructor, before any thread calls set_params().
+     * The params must outlive the block, typically as a member.
+     *
+     * \param name the name of the params for set_params()
+     * \param params a reference to the block params
+     */
+    void register_params(const std::string &name, BlockParamsBase &params);
+
+    /*!
+     * Update registered block params from any thread.
+     * This never waits on the block or sends it a message;
+     * the block sees the new params from its next work call.
+     * Throws if the name is not registered or the type does not match.
+     *
+     * \param name the name of the registered params
+     * \param params the new params
+     */
+    template <typename ParamsType>
+    void set_params(const std::string &name, const ParamsType &params);
+
     /*******************************************************************
      * Direct buffer access API
      ******************************************************************/
@@ -253,6 +366,40 @@ struct GRAS_API Block : Element
      */
     void post_output_buffer(const size_t which_output, const SBuffer &buffer);
 
+    /*******************************************************************
+     * Packet stream API
+     ******************************************************************/
+
+    /*!
+     * Append a record onto a packet stream output port.
+     * The record is copied into the current output buffer
+     * with a small header holding the length and metadata.
+     * Records are never split across buffers; when the record
+     * does not fit, return from work and the buffer will be sent.
+     * Set reserve_items on the output port to fit the largest record.
+     * Do not call produce() for items in the record.
+     *
+     * \param which_output the output port index
+     * \param payload a pointer to the record bytes
+     * \param length the length of the record in bytes
+     * \param meta user metadata for this record
+     * \return true when posted, false when the output buffer is full
+     */
+    bool post_output_record(const size_t which_output, const void *payload, const size_t length, const unsigned meta = 0);
+
+    /*!
+     * Pop the next record from a packet stream input port.
+     * The record references the input buffer, so there is no copy.
+     * Records are consumed as they are popped;
+     * do not call consume() for items in the record.
+     * The input port should be configured with packet_stream.
+     *
+     * \param which_input the input port index
+     * \param record the record view to fill in
+     * \return true when popped, false when the input buffer is empty
+     */
+    bool pop_input_record(const size_t which_input, PacketRecord &record);
+
     /*!
      * Post a buffer to the given input port on this block.
      * This is a thread-safe way for external scheduler
@@ -328,8 +475,14 @@ struct GRAS_API Block : Element
      ******************************************************************/
     virtual PMCC _handle_call(const std::string &, const PMCC &);
     virtual PMCC _handle_call_ts(const std::string &, const PMCC &);
-    void _post_output_msg(const size_t which_output, const PMCC &msg);
+    virtual CallFuture _handle_call_async(const std::string &, const PMCC &);
+    virtual void _handle_call_typed(CallableRegistryEntry &, const void *const *, void *);
+    void _post_output_msg(const size_t which_output, const PMCC &msg, const MsgSlotPtr &slot = MsgSlotPtr());
     void _post_input_msg(const size_t which_input, const PMCC &msg);
+    boost::shared_ptr<MsgSlotPool> _get_msg_slot_pool(const size_t which_output, const std::type_info &type, boost::shared_ptr<MsgSlotPool>(*make_pool)(void));
+    BlockParamsBase &_get_params(const std::string &name, const std::type_info &type);
+    bool _peek_input_msg(const size_t which_input, const PMCC *&msg, const MsgSlot *&slot);
+    void _consume_input_msg(const size_t which_input);
 };
 
 } //namespace gras
@@ -15,6 +15,32 @@
 %import <gras/sbuffer.i>
 %include <gras/buffer_queue.hpp>
 %include <gras/block_config.hpp>
+
+namespace gras
+{
+    //keyed tag lookup is a filter range and not iterable from python
+    %ignore Block::get_input_tags(const size_t, const TagKey &, const item_index_t, const item_index_t);
+
+    //typed msg slots are for C++, python uses the PMC msg api
+    %ignore Block::_post_output_msg(const size_t, const PMCC &, const MsgSlotPtr &);
+    %ignore Block::_get_msg_slot_pool;
+    %ignore Block::_peek_input_msg;
+    %ignore Block::_consume_input_msg;
+
+    //lock-free params are C++ structs
+    %ignore Block::register_params;
+    %ignore Block::set_params;
+    %ignore Block::_get_params;
+
+    //typed and async calls are for C++, python calls by name
+    %ignore Block::_handle_call_typed;
+    %ignore Block::_handle_call_async;
+
+    //packet records are raw memory views
+    %ignore Block::post_output_record;
+    %ignore Block::pop_input_record;
+}
+
 %include <gras/block.hpp>
 
 ////////////////////////////////////////////////////////////////////////
@@ -3,9 +3,16 @@
 #ifndef INCLUDED_GRAS_BLOCK_CONFIG_HPP
 #define INCLUDED_GRAS_BLOCK_CONFIG_HPP
 
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning (disable:4251)  // needs to have dll interface
+#endif //_MSC_VER
+
 #include <gras/gras.hpp>
 #include <gras/thread_pool.hpp>
+#include <gras/tags.hpp>
 #include <cstddef>
+#include <vector>
 
 namespace gras
 {
@@ -46,15 +53,59 @@ struct GRAS_API GlobalBlockConfig
 
     /*!
      * True if the work call should be interruptible by stop().
-     * Some work implementations block with the expectation of
-     * getting a boost thread interrupt in a blocking call.
-     * If this is the case, this parameter should be set true.
+     * Some work implementations block waiting on a resource.
+     * If this is the case, this parameter should be set true,
+     * and work should wait on the block's cancel token,
+     * which is cancelled by stop(); see Block::get_cancel_token().
+     * Work is always called directly from the thread pool.
      * By default, work implementations are not interruptible.
      *
      * Default = false.
      */
     bool interruptible_work;
 
+    /*!
+     * True if the block only uses message ports.
+     * A message-only block never sees stream items:
+     * no output buffers are allocated for it,
+     * incoming stream buffers and tags are discarded,
+     * and work is called as soon as a message arrives,
+     * without any of the per-port stream bookkeeping.
+     * Work must only use the message API,
+     * and the input and output items are always empty.
+     *
+     * This setting describes the block itself,
+     * and so it is never merged from the top block.
+     *
+     * Default = false.
+     */
+    bool message_only;
+
+    /*!
+     * True to track the latency of stream buffers.
+     * Output buffers are stamped with their production time,
+     * and with the origin time of the oldest input data.
+     * Inputs record the queueing delay and the latency
+     * from the origin into histograms for each port,
+     * and the percentiles are reported in the stats.
+     *
+     * Default = false.
+     */
+    bool latency_tracking;
+
+    /*!
+     * True to count hardware events around work calls.
+     * The cycles, instructions, last level cache misses,
+     * and branch misses of the thread that calls work
+     * are accumulated into the stats of the block.
+     * The counters are only available on Linux,
+     * and when perf_event_paranoid allows them;
+     * otherwise the counts stay at zero.
+     *
+     * Default = false.
+     */
+    bool perf_counters;
+
     /*!
      * This member sets the thread pool for the block.
      * The block's actor will migrate to the new pool.
@@ -125,6 +176,50 @@ struct GRAS_API InputPortConfig
      * Default = 0.
      */
     size_t preload_items;
+
+    /*!
+     * Constrain the number of async messages queued on this port.
+     * When the queue holds maximum_msgs messages,
+     * the upstream producer is marked not ready,
+     * until the work routine pops messages off of the queue.
+     * Messages that were already posted are never dropped.
+     *
+     * Default = 0 aka disabled.
+     */
+    size_t maximum_msgs;
+
+    /*!
+     * Set packet stream mode on this input port.
+     * A packet stream carries records written by post_output_record().
+     * In this mode, the scheduler will never accumulate or preload
+     * the input buffers, so that the records in an input buffer
+     * are always whole and start at the front of the buffer.
+     *
+     * Default = false.
+     */
+    bool packet_stream;
+
+    /*!
+     * Subscribe this input port to all stream tags.
+     * When false, only tags listed in consumed_tag_keys are wanted.
+     * Upstream blocks drop the tags that no reachable downstream
+     * subscribes to, rather than posting and propagating them.
+     * Sinks that never read tags should set this false.
+     *
+     * Default = true.
+     */
+    bool consume_all_tags;
+
+    /*!
+     * The keys of the stream tags consumed on this input port.
+     * Keys are interned and matched against StreamTag::get_key_id();
+     * tags that are not a StreamTag are always wanted,
+     * unless the list is empty, which means consume no tags.
+     * Only used when consume_all_tags is false.
+     *
+     * Default = empty.
+     */
+    std::vector<TagKey> consumed_tag_keys;
 };
 
 //! Configuration parameters for an output port
@@ -156,4 +251,8 @@ struct GRAS_API OutputPortConfig
 
 } //namespace gras
 
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif //_MSC_VER
+
 #endif /*INCLUDED_GRAS_BLOCK_CONFIG_HPP*/
@@ -0,0 +1,111 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#ifndef INCLUDED_GRAS_BLOCK_PARAMS_HPP
+#define INCLUDED_GRAS_BLOCK_PARAMS_HPP
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning (disable:4251)  // needs to have dll interface
+#endif //_MSC_VER
+
+#include <gras/gras.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <typeinfo>
+
+namespace gras
+{
+
+/*!
+ * The non-template part of a block params triple buffer.
+ * The latest written slot index is exchanged atomically,
+ * so writers never wait on the block and the block never waits on writers.
+ */
+struct GRAS_API BlockParamsBase : boost::noncopyable
+{
+    BlockParamsBase(void);
+
+    virtual ~BlockParamsBase(void);
+
+    //! The type of the params struct
+    virtual const std::type_info &type(void) const = 0;
+
+    /*!
+     * Latch the last written params for reading.
+     * The block calls this before each work call.
+     * \return true when new params were latched
+     */
+    bool latch(void);
+
+protected:
+    //! Publish the written back slot (call with the write mutex held)
+    void _publish(void);
+
+    boost::mutex _write_mutex;
+    size_t _front; //only touched by the reader
+    size_t _back; //only touched by a writer
+    volatile long _state; //the latest slot and the fresh bit
+};
+
+/*!
+ * Block params are a struct of parameters that any thread may update,
+ * and that the block reads in work() without any messaging.
+ *
+ * The params live in a triple buffer:
+ * a writer copies new params into a spare slot and swaps it in,
+ * and the block latches the latest slot before each work call,
+ * so the params are a consistent snapshot for the entire work call.
+ * Writers from several threads are serialized with each other,
+ * but a writer never waits on the block's work or its actor.
+ *
+ * Register the params in the constructor of the block:
+ * this->register_params("ctrl", _ctrl);
+ *
+ * Read the params in work():
+ * const MyParams &p = _ctrl.get();
+ *
+ * Update the params from any thread:
+ * my_block->set_params("ctrl", new_params);
+ */
+template <typename ParamsType>
+struct BlockParams : BlockParamsBase
+{
+    //! Create block params with initial values
+    BlockParams(const ParamsType &params = ParamsType())
+    {
+        for (size_t i = 0; i < 3; i++) _slots[i] = params;
+    }
+
+    const std::type_info &type(void) const
+    {
+        return typeid(ParamsType);
+    }
+
+    /*!
+     * Get the params latched for the current work call.
+     * Only call this from the block's own context (work or a call handler).
+     */
+    GRAS_FORCE_INLINE const ParamsType &get(void) const
+    {
+        return _slots[_front];
+    }
+
+    //! Write new params, called from any thread
+    void set(const ParamsType &params)
+    {
+        boost::mutex::scoped_lock lock(_write_mutex);
+        _slots[_back] = params;
+        this->_publish();
+    }
+
+private:
+    ParamsType _slots[3];
+};
+
+} //namespace gras
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif //_MSC_VER
+
+#endif /*INCLUDED_GRAS_BLOCK_PARAMS_HPP*/
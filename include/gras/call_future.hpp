@@ -0,0 +1,105 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#ifndef INCLUDED_GRAS_CALL_FUTURE_HPP
+#define INCLUDED_GRAS_CALL_FUTURE_HPP
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning (disable:4251)  // needs to have dll interface
+#endif //_MSC_VER
+
+#include <gras/gras.hpp>
+#include <PMC/PMC.hpp>
+#include <boost/shared_ptr.hpp>
+#include <vector>
+#include <string>
+
+namespace gras
+{
+
+struct CallFutureImpl;
+
+/*!
+ * A call future is the result of an asynchronous call.
+ * Callable::call_async() returns without waiting on the call;
+ * the future gets the return value or error once the call completes.
+ *
+ * All methods are thread-safe.
+ */
+struct GRAS_API CallFuture : boost::shared_ptr<CallFutureImpl>
+{
+    //! Create a null call future
+    CallFuture(void);
+
+    //! Get the name of the call
+    const std::string &name(void) const;
+
+    //! Has the call completed? This is a cheap poll.
+    bool ready(void) const;
+
+    /*!
+     * Wait for the call to complete.
+     * \param timeout the timeout in seconds, negative for forever
+     * \return true when the call completed, false on timeout
+     */
+    bool wait(const double timeout = -1.0) const;
+
+    /*!
+     * Wait for the call and get the return value.
+     * Throws the error of the call when the call failed.
+     */
+    template <typename ReturnType>
+    ReturnType get(void) const
+    {
+        return this->get_pmc().safe_as<ReturnType>();
+    }
+
+    //! Wait for the call and get the return value as a PMC
+    PMCC get_pmc(void) const;
+
+    //! Wait for the call and get the error message (empty on success)
+    std::string get_error(void) const;
+};
+
+/*!
+ * A call batch gathers the futures of calls fanned out to many blocks.
+ * Start all of the calls with call_async() and add their futures,
+ * then wait on the batch once for all of the calls to complete:
+ *
+ * gras::CallBatch batch;
+ * batch.add(block0->call_async("set_gain", 1.0));
+ * batch.add(block1->call_async("set_gain", 2.0));
+ * batch.wait();
+ *
+ * The blocks perform the calls concurrently,
+ * so the batch takes about as long as its slowest call.
+ */
+struct GRAS_API CallBatch
+{
+    //! Add the future of a call, returns its index in the batch
+    size_t add(const CallFuture &future);
+
+    //! Get the number of calls in the batch
+    size_t size(void) const;
+
+    //! Get the future of a call by index
+    const CallFuture &operator[](const size_t index) const;
+
+    /*!
+     * Wait for all of the calls in the batch to complete.
+     * When any of the calls failed, this throws after all calls completed,
+     * and the error message lists every failed call by name.
+     */
+    void wait(void) const;
+
+private:
+    std::vector<CallFuture> _futures;
+};
+
+} //namespace gras
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif //_MSC_VER
+
+#endif /*INCLUDED_GRAS_CALL_FUTURE_HPP*/
@@ -0,0 +1,87 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#ifndef INCLUDED_GRAS_CANCEL_TOKEN_HPP
+#define INCLUDED_GRAS_CANCEL_TOKEN_HPP
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning (disable:4251)  // needs to have dll interface
+#endif //_MSC_VER
+
+#include <gras/gras.hpp>
+#include <boost/shared_ptr.hpp>
+
+namespace gras
+{
+
+struct CancelTokenImpl;
+
+/*!
+ * A cancel token is a cooperative cancellation object.
+ * The top block cancels the token when stop() is called.
+ *
+ * Work implementations that block (typically sources waiting on I/O)
+ * should poll the token or use the interruptible waits below,
+ * so that the work routine yields the thread context on stop().
+ *
+ * Work is always called directly in the thread pool,
+ * so a work routine that blocks forever will hang the flow graph.
+ * Use the cancel token to make sure that never happens.
+ *
+ * All methods are thread-safe.
+ */
+struct GRAS_API CancelToken : boost::shared_ptr<CancelTokenImpl>
+{
+    //! Create a null cancel token
+    CancelToken(void);
+
+    //! Make a new cancel token in the non-cancelled state
+    static CancelToken make(void);
+
+    //! Request cancellation and wake up all waiters
+    void cancel(void) const;
+
+    //! Is cancellation requested? This is a cheap poll.
+    bool cancelled(void) const;
+
+    /*!
+     * Get a file descriptor that becomes readable on cancellation.
+     * Use this to integrate the token into a custom poll/select loop.
+     * Do not read from or close the file descriptor.
+     * \return the file descriptor or -1 when not supported
+     */
+    int get_fd(void) const;
+
+    /*!
+     * Sleep for the timeout or until cancellation.
+     * \param timeout the timeout in seconds
+     * \return true when the full timeout elapsed, false when cancelled
+     */
+    bool wait(const double timeout) const;
+
+    /*!
+     * Wait for the file descriptor to become readable.
+     * The wait ends early on timeout or cancellation.
+     * \param fd a file descriptor (or socket) to wait on
+     * \param timeout the timeout in seconds, negative for forever
+     * \return true when the fd is readable, false on timeout or cancel
+     */
+    bool wait_readable(const int fd, const double timeout = -1.0) const;
+
+    /*!
+     * Wait for the file descriptor to become writable.
+     * The wait ends early on timeout or cancellation.
+     * \param fd a file descriptor (or socket) to wait on
+     * \param timeout the timeout in seconds, negative for forever
+     * \return true when the fd is writable, false on timeout or cancel
+     */
+    bool wait_writable(const int fd, const double timeout = -1.0) const;
+};
+
+} //namespace gras
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif //_MSC_VER
+
+#endif /*INCLUDED_GRAS_CANCEL_TOKEN_HPP*/
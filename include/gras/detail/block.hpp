@@ -3,13 +3,31 @@
 #ifndef INCLUDED_GRAS_DETAIL_BLOCK_HPP
 #define INCLUDED_GRAS_DETAIL_BLOCK_HPP
 
+#include <boost/thread/tss.hpp>
+
 namespace gras
 {
 
+template <typename ValueType>
+GRAS_FORCE_INLINE MsgSlotPoolCache &get_msg_slot_pool_cache(void)
+{
+    static boost::thread_specific_ptr<MsgSlotPoolCache> cache;
+    if GRAS_UNLIKELY(cache.get() == NULL) cache.reset(new MsgSlotPoolCache());
+    return *cache;
+}
+
 template <typename ValueType>
 inline void Block::post_output_msg(const size_t i, const ValueType &value)
 {
-    this->_post_output_msg(i, PMC_M(value));
+    //the pool is looked up once, and then cached by the posting thread
+    MsgSlotPoolCache &cache = get_msg_slot_pool_cache<ValueType>();
+    if GRAS_UNLIKELY(cache.port != i or cache.element.owner_before(*this) or this->owner_before(cache.element))
+    {
+        cache.pool = this->_get_msg_slot_pool(i, typeid(ValueType), &MsgSlotPoolT<ValueType>::make_pool);
+        cache.element = *this;
+        cache.port = i;
+    }
+    this->_post_output_msg(i, PMCC(), static_cast<MsgSlotPoolT<ValueType> &>(*cache.pool).make(value));
 }
 
 template <>
@@ -24,6 +42,31 @@ inline void Block::post_output_msg(const size_t i, const PMC &value)
     this->_post_output_msg(i, value);
 }
 
+template <typename ValueType>
+inline bool Block::pop_input_msg(const size_t i, ValueType &value)
+{
+    const PMCC *msg = NULL;
+    const MsgSlot *slot = NULL;
+    if (not this->_peek_input_msg(i, msg, slot)) return false;
+
+    //typed slot: copy the value out without unboxing
+    if GRAS_LIKELY(slot != NULL)
+    {
+        if (slot->type() != typeid(ValueType)) return false;
+        value = static_cast<const MsgSlotT<ValueType> *>(slot)->value();
+    }
+
+    //boxed message: the PMC fallback
+    else
+    {
+        if (not *msg or not msg->is<ValueType>()) return false;
+        value = msg->as<ValueType>();
+    }
+
+    this->_consume_input_msg(i);
+    return true;
+}
+
 template <typename ValueType>
 inline void Block::post_input_msg(const size_t i, const ValueType &value)
 {
@@ -42,6 +85,12 @@ inline void Block::post_input_msg(const size_t i, const PMC &value)
     this->_post_input_msg(i, value);
 }
 
+template <typename ParamsType>
+inline void Block::set_params(const std::string &name, const ParamsType &params)
+{
+    static_cast<BlockParams<ParamsType> &>(this->_get_params(name, typeid(ParamsType))).set(params);
+}
+
 } //namespace gras
 
 #endif /*INCLUDED_GRAS_DETAIL_BLOCK_HPP*/
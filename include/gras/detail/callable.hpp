@@ -4,6 +4,9 @@
 #define INCLUDED_GRAS_DETAIL_CALLABLE_HPP
 
 #include <PMC/Containers.hpp> //PMCList
+#include <boost/optional.hpp>
+#include <typeinfo>
+#include <stdexcept>
 
 namespace gras
 {
@@ -17,6 +20,19 @@ struct GRAS_API CallableRegistryEntry
     virtual ~CallableRegistryEntry(void);
     virtual PMCC call(const PMCC &args) = 0;
     void arg_check(const PMCList &args, const size_t nargs);
+
+    //! The signature of the method as a function pointer type
+    virtual const std::type_info &signature(void) const = 0;
+
+    /*!
+     * Call the method with typed arguments and without PMC boxing.
+     * The arguments are pointers to values of the exact signature types,
+     * and the return value is stored into a boost::optional<ReturnType>.
+     */
+    virtual void call_typed(const void *const *args, void *ret) = 0;
+
+    //! The last value published for this call, read and written atomically
+    boost::shared_ptr<const PMCC> published;
 };
 
 /***********************************************************************
@@ -34,6 +50,14 @@ struct CallableRegistryEntryImpl0 : CallableRegistryEntry
         this->arg_check(a, 0);
         return PMC_M((_obj->*_fcn)());
     }
+    const std::type_info &signature(void) const
+    {
+        return typeid(ReturnType(*)());
+    }
+    void call_typed(const void *const *args, void *ret)
+    {
+        *reinterpret_cast<boost::optional<ReturnType> *>(ret) = (_obj->*_fcn)();
+    }
     ClassType *_obj; Fcn _fcn;
 };
 
@@ -57,6 +81,14 @@ struct CallableRegistryEntryImplVoid0 : CallableRegistryEntry
         this->arg_check(a, 0);
         (_obj->*_fcn)(); return PMCC();
     }
+    const std::type_info &signature(void) const
+    {
+        return typeid(void(*)());
+    }
+    void call_typed(const void *const *args, void *)
+    {
+        (_obj->*_fcn)();
+    }
     ClassType *_obj; Fcn _fcn;
 };
 
@@ -83,6 +115,14 @@ struct CallableRegistryEntryImpl1 : CallableRegistryEntry
         this->arg_check(a, 1);
         return PMC_M((_obj->*_fcn)(a[0].safe_as<A0>()));
     }
+    const std::type_info &signature(void) const
+    {
+        return typeid(ReturnType(*)(A0));
+    }
+    void call_typed(const void *const *args, void *ret)
+    {
+        *reinterpret_cast<boost::optional<ReturnType> *>(ret) = (_obj->*_fcn)(*reinterpret_cast<const A0 *>(args[0]));
+    }
     ClassType *_obj; Fcn _fcn;
 };
 
@@ -106,6 +146,14 @@ struct CallableRegistryEntryImplVoid1 : CallableRegistryEntry
         this->arg_check(a, 1);
         (_obj->*_fcn)(a[0].safe_as<A0>()); return PMCC();
     }
+    const std::type_info &signature(void) const
+    {
+        return typeid(void(*)(A0));
+    }
+    void call_typed(const void *const *args, void *)
+    {
+        (_obj->*_fcn)(*reinterpret_cast<const A0 *>(args[0]));
+    }
     ClassType *_obj; Fcn _fcn;
 };
 
@@ -132,6 +180,14 @@ struct CallableRegistryEntryImpl2 : CallableRegistryEntry
         this->arg_check(a, 2);
         return PMC_M((_obj->*_fcn)(a[0].safe_as<A0>(), a[1].safe_as<A1>()));
     }
+    const std::type_info &signature(void) const
+    {
+        return typeid(ReturnType(*)(A0, A1));
+    }
+    void call_typed(const void *const *args, void *ret)
+    {
+        *reinterpret_cast<boost::optional<ReturnType> *>(ret) = (_obj->*_fcn)(*reinterpret_cast<const A0 *>(args[0]), *reinterpret_cast<const A1 *>(args[1]));
+    }
     ClassType *_obj; Fcn _fcn;
 };
 
@@ -155,6 +211,14 @@ struct CallableRegistryEntryImplVoid2 : CallableRegistryEntry
         this->arg_check(a, 2);
         (_obj->*_fcn)(a[0].safe_as<A0>(), a[1].safe_as<A1>()); return PMCC();
     }
+    const std::type_info &signature(void) const
+    {
+        return typeid(void(*)(A0, A1));
+    }
+    void call_typed(const void *const *args, void *)
+    {
+        (_obj->*_fcn)(*reinterpret_cast<const A0 *>(args[0]), *reinterpret_cast<const A1 *>(args[1]));
+    }
     ClassType *_obj; Fcn _fcn;
 };
 
@@ -181,6 +245,14 @@ struct CallableRegistryEntryImpl3 : CallableRegistryEntry
         this->arg_check(a, 3);
         return PMC_M((_obj->*_fcn)(a[0].safe_as<A0>(), a[1].safe_as<A1>(), a[2].safe_as<A2>()));
     }
+    const std::type_info &signature(void) const
+    {
+        return typeid(ReturnType(*)(A0, A1, A2));
+    }
+    void call_typed(const void *const *args, void *ret)
+    {
+        *reinterpret_cast<boost::optional<ReturnType> *>(ret) = (_obj->*_fcn)(*reinterpret_cast<const A0 *>(args[0]), *reinterpret_cast<const A1 *>(args[1]), *reinterpret_cast<const A2 *>(args[2]));
+    }
     ClassType *_obj; Fcn _fcn;
 };
 
@@ -204,6 +276,14 @@ struct CallableRegistryEntryImplVoid3 : CallableRegistryEntry
         this->arg_check(a, 3);
         (_obj->*_fcn)(a[0].safe_as<A0>(), a[1].safe_as<A1>(), a[2].safe_as<A2>()); return PMCC();
     }
+    const std::type_info &signature(void) const
+    {
+        return typeid(void(*)(A0, A1, A2));
+    }
+    void call_typed(const void *const *args, void *)
+    {
+        (_obj->*_fcn)(*reinterpret_cast<const A0 *>(args[0]), *reinterpret_cast<const A1 *>(args[1]), *reinterpret_cast<const A2 *>(args[2]));
+    }
     ClassType *_obj; Fcn _fcn;
 };
 
@@ -230,6 +310,14 @@ struct CallableRegistryEntryImpl4 : CallableRegistryEntry
         this->arg_check(a, 4);
         return PMC_M((_obj->*_fcn)(a[0].safe_as<A0>(), a[1].safe_as<A1>(), a[2].safe_as<A2>(), a[3].safe_as<A3>()));
     }
+    const std::type_info &signature(void) const
+    {
+        return typeid(ReturnType(*)(A0, A1, A2, A3));
+    }
+    void call_typed(const void *const *args, void *ret)
+    {
+        *reinterpret_cast<boost::optional<ReturnType> *>(ret) = (_obj->*_fcn)(*reinterpret_cast<const A0 *>(args[0]), *reinterpret_cast<const A1 *>(args[1]), *reinterpret_cast<const A2 *>(args[2]), *reinterpret_cast<const A3 *>(args[3]));
+    }
     ClassType *_obj; Fcn _fcn;
 };
 
@@ -253,6 +341,14 @@ struct CallableRegistryEntryImplVoid4 : CallableRegistryEntry
         this->arg_check(a, 4);
         (_obj->*_fcn)(a[0].safe_as<A0>(), a[1].safe_as<A1>(), a[2].safe_as<A2>(), a[3].safe_as<A3>()); return PMCC();
     }
+    const std::type_info &signature(void) const
+    {
+        return typeid(void(*)(A0, A1, A2, A3));
+    }
+    void call_typed(const void *const *args, void *)
+    {
+        (_obj->*_fcn)(*reinterpret_cast<const A0 *>(args[0]), *reinterpret_cast<const A1 *>(args[1]), *reinterpret_cast<const A2 *>(args[2]), *reinterpret_cast<const A3 *>(args[3]));
+    }
     ClassType *_obj; Fcn _fcn;
 };
 
@@ -279,6 +375,14 @@ struct CallableRegistryEntryImpl5 : CallableRegistryEntry
         this->arg_check(a, 5);
         return PMC_M((_obj->*_fcn)(a[0].safe_as<A0>(), a[1].safe_as<A1>(), a[2].safe_as<A2>(), a[3].safe_as<A3>(), a[4].safe_as<A4>()));
     }
+    const std::type_info &signature(void) const
+    {
+        return typeid(ReturnType(*)(A0, A1, A2, A3, A4));
+    }
+    void call_typed(const void *const *args, void *ret)
+    {
+        *reinterpret_cast<boost::optional<ReturnType> *>(ret) = (_obj->*_fcn)(*reinterpret_cast<const A0 *>(args[0]), *reinterpret_cast<const A1 *>(args[1]), *reinterpret_cast<const A2 *>(args[2]), *reinterpret_cast<const A3 *>(args[3]), *reinterpret_cast<const A4 *>(args[4]));
+    }
     ClassType *_obj; Fcn _fcn;
 };
 
@@ -302,6 +406,14 @@ struct CallableRegistryEntryImplVoid5 : CallableRegistryEntry
         this->arg_check(a, 5);
         (_obj->*_fcn)(a[0].safe_as<A0>(), a[1].safe_as<A1>(), a[2].safe_as<A2>(), a[3].safe_as<A3>(), a[4].safe_as<A4>()); return PMCC();
     }
+    const std::type_info &signature(void) const
+    {
+        return typeid(void(*)(A0, A1, A2, A3, A4));
+    }
+    void call_typed(const void *const *args, void *)
+    {
+        (_obj->*_fcn)(*reinterpret_cast<const A0 *>(args[0]), *reinterpret_cast<const A1 *>(args[1]), *reinterpret_cast<const A2 *>(args[2]), *reinterpret_cast<const A3 *>(args[3]), *reinterpret_cast<const A4 *>(args[4]));
+    }
     ClassType *_obj; Fcn _fcn;
 };
 
@@ -328,6 +440,14 @@ struct CallableRegistryEntryImpl6 : CallableRegistryEntry
         this->arg_check(a, 6);
         return PMC_M((_obj->*_fcn)(a[0].safe_as<A0>(), a[1].safe_as<A1>(), a[2].safe_as<A2>(), a[3].safe_as<A3>(), a[4].safe_as<A4>(), a[5].safe_as<A5>()));
     }
+    const std::type_info &signature(void) const
+    {
+        return typeid(ReturnType(*)(A0, A1, A2, A3, A4, A5));
+    }
+    void call_typed(const void *const *args, void *ret)
+    {
+        *reinterpret_cast<boost::optional<ReturnType> *>(ret) = (_obj->*_fcn)(*reinterpret_cast<const A0 *>(args[0]), *reinterpret_cast<const A1 *>(args[1]), *reinterpret_cast<const A2 *>(args[2]), *reinterpret_cast<const A3 *>(args[3]), *reinterpret_cast<const A4 *>(args[4]), *reinterpret_cast<const A5 *>(args[5]));
+    }
     ClassType *_obj; Fcn _fcn;
 };
 
@@ -351,6 +471,14 @@ struct CallableRegistryEntryImplVoid6 : CallableRegistryEntry
         this->arg_check(a, 6);
         (_obj->*_fcn)(a[0].safe_as<A0>(), a[1].safe_as<A1>(), a[2].safe_as<A2>(), a[3].safe_as<A3>(), a[4].safe_as<A4>(), a[5].safe_as<A5>()); return PMCC();
     }
+    const std::type_info &signature(void) const
+    {
+        return typeid(void(*)(A0, A1, A2, A3, A4, A5));
+    }
+    void call_typed(const void *const *args, void *)
+    {
+        (_obj->*_fcn)(*reinterpret_cast<const A0 *>(args[0]), *reinterpret_cast<const A1 *>(args[1]), *reinterpret_cast<const A2 *>(args[2]), *reinterpret_cast<const A3 *>(args[3]), *reinterpret_cast<const A4 *>(args[4]), *reinterpret_cast<const A5 *>(args[5]));
+    }
     ClassType *_obj; Fcn _fcn;
 };
 
@@ -377,6 +505,14 @@ struct CallableRegistryEntryImpl7 : CallableRegistryEntry
         this->arg_check(a, 7);
         return PMC_M((_obj->*_fcn)(a[0].safe_as<A0>(), a[1].safe_as<A1>(), a[2].safe_as<A2>(), a[3].safe_as<A3>(), a[4].safe_as<A4>(), a[5].safe_as<A5>(), a[6].safe_as<A6>()));
     }
+    const std::type_info &signature(void) const
+    {
+        return typeid(ReturnType(*)(A0, A1, A2, A3, A4, A5, A6));
+    }
+    void call_typed(const void *const *args, void *ret)
+    {
+        *reinterpret_cast<boost::optional<ReturnType> *>(ret) = (_obj->*_fcn)(*reinterpret_cast<const A0 *>(args[0]), *reinterpret_cast<const A1 *>(args[1]), *reinterpret_cast<const A2 *>(args[2]), *reinterpret_cast<const A3 *>(args[3]), *reinterpret_cast<const A4 *>(args[4]), *reinterpret_cast<const A5 *>(args[5]), *reinterpret_cast<const A6 *>(args[6]));
+    }
     ClassType *_obj; Fcn _fcn;
 };
 
@@ -400,6 +536,14 @@ struct CallableRegistryEntryImplVoid7 : CallableRegistryEntry
         this->arg_check(a, 7);
         (_obj->*_fcn)(a[0].safe_as<A0>(), a[1].safe_as<A1>(), a[2].safe_as<A2>(), a[3].safe_as<A3>(), a[4].safe_as<A4>(), a[5].safe_as<A5>(), a[6].safe_as<A6>()); return PMCC();
     }
+    const std::type_info &signature(void) const
+    {
+        return typeid(void(*)(A0, A1, A2, A3, A4, A5, A6));
+    }
+    void call_typed(const void *const *args, void *)
+    {
+        (_obj->*_fcn)(*reinterpret_cast<const A0 *>(args[0]), *reinterpret_cast<const A1 *>(args[1]), *reinterpret_cast<const A2 *>(args[2]), *reinterpret_cast<const A3 *>(args[3]), *reinterpret_cast<const A4 *>(args[4]), *reinterpret_cast<const A5 *>(args[5]), *reinterpret_cast<const A6 *>(args[6]));
+    }
     ClassType *_obj; Fcn _fcn;
 };
 
@@ -426,6 +570,14 @@ struct CallableRegistryEntryImpl8 : CallableRegistryEntry
         this->arg_check(a, 8);
         return PMC_M((_obj->*_fcn)(a[0].safe_as<A0>(), a[1].safe_as<A1>(), a[2].safe_as<A2>(), a[3].safe_as<A3>(), a[4].safe_as<A4>(), a[5].safe_as<A5>(), a[6].safe_as<A6>(), a[7].safe_as<A7>()));
     }
+    const std::type_info &signature(void) const
+    {
+        return typeid(ReturnType(*)(A0, A1, A2, A3, A4, A5, A6, A7));
+    }
+    void call_typed(const void *const *args, void *ret)
+    {
+        *reinterpret_cast<boost::optional<ReturnType> *>(ret) = (_obj->*_fcn)(*reinterpret_cast<const A0 *>(args[0]), *reinterpret_cast<const A1 *>(args[1]), *reinterpret_cast<const A2 *>(args[2]), *reinterpret_cast<const A3 *>(args[3]), *reinterpret_cast<const A4 *>(args[4]), *reinterpret_cast<const A5 *>(args[5]), *reinterpret_cast<const A6 *>(args[6]), *reinterpret_cast<const A7 *>(args[7]));
+    }
     ClassType *_obj; Fcn _fcn;
 };
 
@@ -449,6 +601,14 @@ struct CallableRegistryEntryImplVoid8 : CallableRegistryEntry
         this->arg_check(a, 8);
         (_obj->*_fcn)(a[0].safe_as<A0>(), a[1].safe_as<A1>(), a[2].safe_as<A2>(), a[3].safe_as<A3>(), a[4].safe_as<A4>(), a[5].safe_as<A5>(), a[6].safe_as<A6>(), a[7].safe_as<A7>()); return PMCC();
     }
+    const std::type_info &signature(void) const
+    {
+        return typeid(void(*)(A0, A1, A2, A3, A4, A5, A6, A7));
+    }
+    void call_typed(const void *const *args, void *)
+    {
+        (_obj->*_fcn)(*reinterpret_cast<const A0 *>(args[0]), *reinterpret_cast<const A1 *>(args[1]), *reinterpret_cast<const A2 *>(args[2]), *reinterpret_cast<const A3 *>(args[3]), *reinterpret_cast<const A4 *>(args[4]), *reinterpret_cast<const A5 *>(args[5]), *reinterpret_cast<const A6 *>(args[6]), *reinterpret_cast<const A7 *>(args[7]));
+    }
     ClassType *_obj; Fcn _fcn;
 };
 
@@ -475,6 +635,14 @@ struct CallableRegistryEntryImpl9 : CallableRegistryEntry
         this->arg_check(a, 9);
         return PMC_M((_obj->*_fcn)(a[0].safe_as<A0>(), a[1].safe_as<A1>(), a[2].safe_as<A2>(), a[3].safe_as<A3>(), a[4].safe_as<A4>(), a[5].safe_as<A5>(), a[6].safe_as<A6>(), a[7].safe_as<A7>(), a[8].safe_as<A8>()));
     }
+    const std::type_info &signature(void) const
+    {
+        return typeid(ReturnType(*)(A0, A1, A2, A3, A4, A5, A6, A7, A8));
+    }
+    void call_typed(const void *const *args, void *ret)
+    {
+        *reinterpret_cast<boost::optional<ReturnType> *>(ret) = (_obj->*_fcn)(*reinterpret_cast<const A0 *>(args[0]), *reinterpret_cast<const A1 *>(args[1]), *reinterpret_cast<const A2 *>(args[2]), *reinterpret_cast<const A3 *>(args[3]), *reinterpret_cast<const A4 *>(args[4]), *reinterpret_cast<const A5 *>(args[5]), *reinterpret_cast<const A6 *>(args[6]), *reinterpret_cast<const A7 *>(args[7]), *reinterpret_cast<const A8 *>(args[8]));
+    }
     ClassType *_obj; Fcn _fcn;
 };
 
@@ -498,6 +666,14 @@ struct CallableRegistryEntryImplVoid9 : CallableRegistryEntry
         this->arg_check(a, 9);
         (_obj->*_fcn)(a[0].safe_as<A0>(), a[1].safe_as<A1>(), a[2].safe_as<A2>(), a[3].safe_as<A3>(), a[4].safe_as<A4>(), a[5].safe_as<A5>(), a[6].safe_as<A6>(), a[7].safe_as<A7>(), a[8].safe_as<A8>()); return PMCC();
     }
+    const std::type_info &signature(void) const
+    {
+        return typeid(void(*)(A0, A1, A2, A3, A4, A5, A6, A7, A8));
+    }
+    void call_typed(const void *const *args, void *)
+    {
+        (_obj->*_fcn)(*reinterpret_cast<const A0 *>(args[0]), *reinterpret_cast<const A1 *>(args[1]), *reinterpret_cast<const A2 *>(args[2]), *reinterpret_cast<const A3 *>(args[3]), *reinterpret_cast<const A4 *>(args[4]), *reinterpret_cast<const A5 *>(args[5]), *reinterpret_cast<const A6 *>(args[6]), *reinterpret_cast<const A7 *>(args[7]), *reinterpret_cast<const A8 *>(args[8]));
+    }
     ClassType *_obj; Fcn _fcn;
 };
 
@@ -524,6 +700,14 @@ struct CallableRegistryEntryImpl10 : CallableRegistryEntry
         this->arg_check(a, 10);
         return PMC_M((_obj->*_fcn)(a[0].safe_as<A0>(), a[1].safe_as<A1>(), a[2].safe_as<A2>(), a[3].safe_as<A3>(), a[4].safe_as<A4>(), a[5].safe_as<A5>(), a[6].safe_as<A6>(), a[7].safe_as<A7>(), a[8].safe_as<A8>(), a[9].safe_as<A9>()));
     }
+    const std::type_info &signature(void) const
+    {
+        return typeid(ReturnType(*)(A0, A1, A2, A3, A4, A5, A6, A7, A8, A9));
+    }
+    void call_typed(const void *const *args, void *ret)
+    {
+        *reinterpret_cast<boost::optional<ReturnType> *>(ret) = (_obj->*_fcn)(*reinterpret_cast<const A0 *>(args[0]), *reinterpret_cast<const A1 *>(args[1]), *reinterpret_cast<const A2 *>(args[2]), *reinterpret_cast<const A3 *>(args[3]), *reinterpret_cast<const A4 *>(args[4]), *reinterpret_cast<const A5 *>(args[5]), *reinterpret_cast<const A6 *>(args[6]), *reinterpret_cast<const A7 *>(args[7]), *reinterpret_cast<const A8 *>(args[8]), *reinterpret_cast<const A9 *>(args[9]));
+    }
     ClassType *_obj; Fcn _fcn;
 };
 
@@ -547,6 +731,14 @@ struct CallableRegistryEntryImplVoid10 : CallableRegistryEntry
         this->arg_check(a, 10);
         (_obj->*_fcn)(a[0].safe_as<A0>(), a[1].safe_as<A1>(), a[2].safe_as<A2>(), a[3].safe_as<A3>(), a[4].safe_as<A4>(), a[5].safe_as<A5>(), a[6].safe_as<A6>(), a[7].safe_as<A7>(), a[8].safe_as<A8>(), a[9].safe_as<A9>()); return PMCC();
     }
+    const std::type_info &signature(void) const
+    {
+        return typeid(void(*)(A0, A1, A2, A3, A4, A5, A6, A7, A8, A9));
+    }
+    void call_typed(const void *const *args, void *)
+    {
+        (_obj->*_fcn)(*reinterpret_cast<const A0 *>(args[0]), *reinterpret_cast<const A1 *>(args[1]), *reinterpret_cast<const A2 *>(args[2]), *reinterpret_cast<const A3 *>(args[3]), *reinterpret_cast<const A4 *>(args[4]), *reinterpret_cast<const A5 *>(args[5]), *reinterpret_cast<const A6 *>(args[6]), *reinterpret_cast<const A7 *>(args[7]), *reinterpret_cast<const A8 *>(args[8]), *reinterpret_cast<const A9 *>(args[9]));
+    }
     ClassType *_obj; Fcn _fcn;
 };
 
@@ -866,6 +1058,639 @@ void Callable::x(const std::string &name, const A0 &a0, const A1 &a1, const A2 &
     _handle_call(name, PMC_M(args));
 }
 
+/***********************************************************************
+ * Async call implementations with 0 args
+ **********************************************************************/
+inline
+CallFuture Callable::call_async(const std::string &name)
+{
+    PMCList args(0);
+    return _handle_call_async(name, PMC_M(args));
+}
+
+/***********************************************************************
+ * Async call implementations with 1 args
+ **********************************************************************/
+template <typename A0>
+CallFuture Callable::call_async(const std::string &name, const A0 &a0)
+{
+    PMCList args(1);
+    args[0] = PMC_M(a0);
+    return _handle_call_async(name, PMC_M(args));
+}
+
+/***********************************************************************
+ * Async call implementations with 2 args
+ **********************************************************************/
+template <typename A0, typename A1>
+CallFuture Callable::call_async(const std::string &name, const A0 &a0, const A1 &a1)
+{
+    PMCList args(2);
+    args[0] = PMC_M(a0);
+    args[1] = PMC_M(a1);
+    return _handle_call_async(name, PMC_M(args));
+}
+
+/***********************************************************************
+ * Async call implementations with 3 args
+ **********************************************************************/
+template <typename A0, typename A1, typename A2>
+CallFuture Callable::call_async(const std::string &name, const A0 &a0, const A1 &a1, const A2 &a2)
+{
+    PMCList args(3);
+    args[0] = PMC_M(a0);
+    args[1] = PMC_M(a1);
+    args[2] = PMC_M(a2);
+    return _handle_call_async(name, PMC_M(args));
+}
+
+/***********************************************************************
+ * Async call implementations with 4 args
+ **********************************************************************/
+template <typename A0, typename A1, typename A2, typename A3>
+CallFuture Callable::call_async(const std::string &name, const A0 &a0, const A1 &a1, const A2 &a2, const A3 &a3)
+{
+    PMCList args(4);
+    args[0] = PMC_M(a0);
+    args[1] = PMC_M(a1);
+    args[2] = PMC_M(a2);
+    args[3] = PMC_M(a3);
+    return _handle_call_async(name, PMC_M(args));
+}
+
+/***********************************************************************
+ * Async call implementations with 5 args
+ **********************************************************************/
+template <typename A0, typename A1, typename A2, typename A3, typename A4>
+CallFuture Callable::call_async(const std::string &name, const A0 &a0, const A1 &a1, const A2 &a2, const A3 &a3, const A4 &a4)
+{
+    PMCList args(5);
+    args[0] = PMC_M(a0);
+    args[1] = PMC_M(a1);
+    args[2] = PMC_M(a2);
+    args[3] = PMC_M(a3);
+    args[4] = PMC_M(a4);
+    return _handle_call_async(name, PMC_M(args));
+}
+
+/***********************************************************************
+ * Async call implementations with 6 args
+ **********************************************************************/
+template <typename A0, typename A1, typename A2, typename A3, typename A4, typename A5>
+CallFuture Callable::call_async(const std::string &name, const A0 &a0, const A1 &a1, const A2 &a2, const A3 &a3, const A4 &a4, const A5 &a5)
+{
+    PMCList args(6);
+    args[0] = PMC_M(a0);
+    args[1] = PMC_M(a1);
+    args[2] = PMC_M(a2);
+    args[3] = PMC_M(a3);
+    args[4] = PMC_M(a4);
+    args[5] = PMC_M(a5);
+    return _handle_call_async(name, PMC_M(args));
+}
+
+/***********************************************************************
+ * Async call implementations with 7 args
+ **********************************************************************/
+template <typename A0, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6>
+CallFuture Callable::call_async(const std::string &name, const A0 &a0, const A1 &a1, const A2 &a2, const A3 &a3, const A4 &a4, const A5 &a5, const A6 &a6)
+{
+    PMCList args(7);
+    args[0] = PMC_M(a0);
+    args[1] = PMC_M(a1);
+    args[2] = PMC_M(a2);
+    args[3] = PMC_M(a3);
+    args[4] = PMC_M(a4);
+    args[5] = PMC_M(a5);
+    args[6] = PMC_M(a6);
+    return _handle_call_async(name, PMC_M(args));
+}
+
+/***********************************************************************
+ * Async call implementations with 8 args
+ **********************************************************************/
+template <typename A0, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7>
+CallFuture Callable::call_async(const std::string &name, const A0 &a0, const A1 &a1, const A2 &a2, const A3 &a3, const A4 &a4, const A5 &a5, const A6 &a6, const A7 &a7)
+{
+    PMCList args(8);
+    args[0] = PMC_M(a0);
+    args[1] = PMC_M(a1);
+    args[2] = PMC_M(a2);
+    args[3] = PMC_M(a3);
+    args[4] = PMC_M(a4);
+    args[5] = PMC_M(a5);
+    args[6] = PMC_M(a6);
+    args[7] = PMC_M(a7);
+    return _handle_call_async(name, PMC_M(args));
+}
+
+/***********************************************************************
+ * Async call implementations with 9 args
+ **********************************************************************/
+template <typename A0, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8>
+CallFuture Callable::call_async(const std::string &name, const A0 &a0, const A1 &a1, const A2 &a2, const A3 &a3, const A4 &a4, const A5 &a5, const A6 &a6, const A7 &a7, const A8 &a8)
+{
+    PMCList args(9);
+    args[0] = PMC_M(a0);
+    args[1] = PMC_M(a1);
+    args[2] = PMC_M(a2);
+    args[3] = PMC_M(a3);
+    args[4] = PMC_M(a4);
+    args[5] = PMC_M(a5);
+    args[6] = PMC_M(a6);
+    args[7] = PMC_M(a7);
+    args[8] = PMC_M(a8);
+    return _handle_call_async(name, PMC_M(args));
+}
+
+/***********************************************************************
+ * Async call implementations with 10 args
+ **********************************************************************/
+template <typename A0, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9>
+CallFuture Callable::call_async(const std::string &name, const A0 &a0, const A1 &a1, const A2 &a2, const A3 &a3, const A4 &a4, const A5 &a5, const A6 &a6, const A7 &a7, const A8 &a8, const A9 &a9)
+{
+    PMCList args(10);
+    args[0] = PMC_M(a0);
+    args[1] = PMC_M(a1);
+    args[2] = PMC_M(a2);
+    args[3] = PMC_M(a3);
+    args[4] = PMC_M(a4);
+    args[5] = PMC_M(a5);
+    args[6] = PMC_M(a6);
+    args[7] = PMC_M(a7);
+    args[8] = PMC_M(a8);
+    args[9] = PMC_M(a9);
+    return _handle_call_async(name, PMC_M(args));
+}
+
+/***********************************************************************
+ * Published values for call handles
+ **********************************************************************/
+template <typename ValueType>
+void Callable::publish_call(const std::string &name, const ValueType &value)
+{
+    _publish_call(name, PMC_M(value));
+}
+
+template <typename ReturnType>
+ReturnType CallHandle::read(void) const
+{
+    const boost::shared_ptr<const PMCC> published = boost::atomic_load(&_entry->published);
+    if (not published) throw std::runtime_error("CallHandle - no value published for call: " + _name);
+    return published->safe_as<ReturnType>();
+}
+
+/***********************************************************************
+ * Call handle implementations with 0 args
+ **********************************************************************/
+template <typename ReturnType>
+ReturnType CallHandle::x() const
+{
+    if (_entry->signature() == typeid(ReturnType(*)()))
+    {
+        const void *args[0+1] = {};
+        boost::optional<ReturnType> r;
+        _callable->_handle_call_typed(*_entry, args, &r);
+        return r.get();
+    }
+    PMCList args(0);
+    PMCC r = _callable->_handle_call(_name, PMC_M(args));
+    return r.safe_as<ReturnType>();
+}
+
+inline
+void CallHandle::x() const
+{
+    if (_entry->signature() == typeid(void(*)()))
+    {
+        const void *args[0+1] = {};
+        _callable->_handle_call_typed(*_entry, args, NULL);
+        return;
+    }
+    PMCList args(0);
+    _callable->_handle_call(_name, PMC_M(args));
+}
+
+/***********************************************************************
+ * Call handle implementations with 1 args
+ **********************************************************************/
+template <typename ReturnType, typename A0>
+ReturnType CallHandle::x(const A0 &a0) const
+{
+    if (_entry->signature() == typeid(ReturnType(*)(A0)))
+    {
+        const void *args[1+1] = {&a0};
+        boost::optional<ReturnType> r;
+        _callable->_handle_call_typed(*_entry, args, &r);
+        return r.get();
+    }
+    PMCList args(1);
+    args[0] = PMC_M(a0);
+    PMCC r = _callable->_handle_call(_name, PMC_M(args));
+    return r.safe_as<ReturnType>();
+}
+
+template <typename A0>
+void CallHandle::x(const A0 &a0) const
+{
+    if (_entry->signature() == typeid(void(*)(A0)))
+    {
+        const void *args[1+1] = {&a0};
+        _callable->_handle_call_typed(*_entry, args, NULL);
+        return;
+    }
+    PMCList args(1);
+    args[0] = PMC_M(a0);
+    _callable->_handle_call(_name, PMC_M(args));
+}
+
+/***********************************************************************
+ * Call handle implementations with 2 args
+ **********************************************************************/
+template <typename ReturnType, typename A0, typename A1>
+ReturnType CallHandle::x(const A0 &a0, const A1 &a1) const
+{
+    if (_entry->signature() == typeid(ReturnType(*)(A0, A1)))
+    {
+        const void *args[2+1] = {&a0, &a1};
+        boost::optional<ReturnType> r;
+        _callable->_handle_call_typed(*_entry, args, &r);
+        return r.get();
+    }
+    PMCList args(2);
+    args[0] = PMC_M(a0);
+    args[1] = PMC_M(a1);
+    PMCC r = _callable->_handle_call(_name, PMC_M(args));
+    return r.safe_as<ReturnType>();
+}
+
+template <typename A0, typename A1>
+void CallHandle::x(const A0 &a0, const A1 &a1) const
+{
+    if (_entry->signature() == typeid(void(*)(A0, A1)))
+    {
+        const void *args[2+1] = {&a0, &a1};
+        _callable->_handle_call_typed(*_entry, args, NULL);
+        return;
+    }
+    PMCList args(2);
+    args[0] = PMC_M(a0);
+    args[1] = PMC_M(a1);
+    _callable->_handle_call(_name, PMC_M(args));
+}
+
+/***********************************************************************
+ * Call handle implementations with 3 args
+ **********************************************************************/
+template <typename ReturnType, typename A0, typename A1, typename A2>
+ReturnType CallHandle::x(const A0 &a0, const A1 &a1, const A2 &a2) const
+{
+    if (_entry->signature() == typeid(ReturnType(*)(A0, A1, A2)))
+    {
+        const void *args[3+1] = {&a0, &a1, &a2};
+        boost::optional<ReturnType> r;
+        _callable->_handle_call_typed(*_entry, args, &r);
+        return r.get();
+    }
+    PMCList args(3);
+    args[0] = PMC_M(a0);
+    args[1] = PMC_M(a1);
+    args[2] = PMC_M(a2);
+    PMCC r = _callable->_handle_call(_name, PMC_M(args));
+    return r.safe_as<ReturnType>();
+}
+
+template <typename A0, typename A1, typename A2>
+void CallHandle::x(const A0 &a0, const A1 &a1, const A2 &a2) const
+{
+    if (_entry->signature() == typeid(void(*)(A0, A1, A2)))
+    {
+        const void *args[3+1] = {&a0, &a1, &a2};
+        _callable->_handle_call_typed(*_entry, args, NULL);
+        return;
+    }
+    PMCList args(3);
+    args[0] = PMC_M(a0);
+    args[1] = PMC_M(a1);
+    args[2] = PMC_M(a2);
+    _callable->_handle_call(_name, PMC_M(args));
+}
+
+/***********************************************************************
+ * Call handle implementations with 4 args
+ **********************************************************************/
+template <typename ReturnType, typename A0, typename A1, typename A2, typename A3>
+ReturnType CallHandle::x(const A0 &a0, const A1 &a1, const A2 &a2, const A3 &a3) const
+{
+    if (_entry->signature() == typeid(ReturnType(*)(A0, A1, A2, A3)))
+    {
+        const void *args[4+1] = {&a0, &a1, &a2, &a3};
+        boost::optional<ReturnType> r;
+        _callable->_handle_call_typed(*_entry, args, &r);
+        return r.get();
+    }
+    PMCList args(4);
+    args[0] = PMC_M(a0);
+    args[1] = PMC_M(a1);
+    args[2] = PMC_M(a2);
+    args[3] = PMC_M(a3);
+    PMCC r = _callable->_handle_call(_name, PMC_M(args));
+    return r.safe_as<ReturnType>();
+}
+
+template <typename A0, typename A1, typename A2, typename A3>
+void CallHandle::x(const A0 &a0, const A1 &a1, const A2 &a2, const A3 &a3) const
+{
+    if (_entry->signature() == typeid(void(*)(A0, A1, A2, A3)))
+    {
+        const void *args[4+1] = {&a0, &a1, &a2, &a3};
+        _callable->_handle_call_typed(*_entry, args, NULL);
+        return;
+    }
+    PMCList args(4);
+    args[0] = PMC_M(a0);
+    args[1] = PMC_M(a1);
+    args[2] = PMC_M(a2);
+    args[3] = PMC_M(a3);
+    _callable->_handle_call(_name, PMC_M(args));
+}
+
+/***********************************************************************
+ * Call handle implementations with 5 args
+ **********************************************************************/
+template <typename ReturnType, typename A0, typename A1, typename A2, typename A3, typename A4>
+ReturnType CallHandle::x(const A0 &a0, const A1 &a1, const A2 &a2, const A3 &a3, const A4 &a4) const
+{
+    if (_entry->signature() == typeid(ReturnType(*)(A0, A1, A2, A3, A4)))
+    {
+        const void *args[5+1] = {&a0, &a1, &a2, &a3, &a4};
+        boost::optional<ReturnType> r;
+        _callable->_handle_call_typed(*_entry, args, &r);
+        return r.get();
+    }
+    PMCList args(5);
+    args[0] = PMC_M(a0);
+    args[1] = PMC_M(a1);
+    args[2] = PMC_M(a2);
+    args[3] = PMC_M(a3);
+    args[4] = PMC_M(a4);
+    PMCC r = _callable->_handle_call(_name, PMC_M(args));
+    return r.safe_as<ReturnType>();
+}
+
+template <typename A0, typename A1, typename A2, typename A3, typename A4>
+void CallHandle::x(const A0 &a0, const A1 &a1, const A2 &a2, const A3 &a3, const A4 &a4) const
+{
+    if (_entry->signature() == typeid(void(*)(A0, A1, A2, A3, A4)))
+    {
+        const void *args[5+1] = {&a0, &a1, &a2, &a3, &a4};
+        _callable->_handle_call_typed(*_entry, args, NULL);
+        return;
+    }
+    PMCList args(5);
+    args[0] = PMC_M(a0);
+    args[1] = PMC_M(a1);
+    args[2] = PMC_M(a2);
+    args[3] = PMC_M(a3);
+    args[4] = PMC_M(a4);
+    _callable->_handle_call(_name, PMC_M(args));
+}
+
+/***********************************************************************
+ * Call handle implementations with 6 args
+ **********************************************************************/
+template <typename ReturnType, typename A0, typename A1, typename A2, typename A3, typename A4, typename A5>
+ReturnType CallHandle::x(const A0 &a0, const A1 &a1, const A2 &a2, const A3 &a3, const A4 &a4, const A5 &a5) const
+{
+    if (_entry->signature() == typeid(ReturnType(*)(A0, A1, A2, A3, A4, A5)))
+    {
+        const void *args[6+1] = {&a0, &a1, &a2, &a3, &a4, &a5};
+        boost::optional<ReturnType> r;
+        _callable->_handle_call_typed(*_entry, args, &r);
+        return r.get();
+    }
+    PMCList args(6);
+    args[0] = PMC_M(a0);
+    args[1] = PMC_M(a1);
+    args[2] = PMC_M(a2);
+    args[3] = PMC_M(a3);
+    args[4] = PMC_M(a4);
+    args[5] = PMC_M(a5);
+    PMCC r = _callable->_handle_call(_name, PMC_M(args));
+    return r.safe_as<ReturnType>();
+}
+
+template <typename A0, typename A1, typename A2, typename A3, typename A4, typename A5>
+void CallHandle::x(const A0 &a0, const A1 &a1, const A2 &a2, const A3 &a3, const A4 &a4, const A5 &a5) const
+{
+    if (_entry->signature() == typeid(void(*)(A0, A1, A2, A3, A4, A5)))
+    {
+        const void *args[6+1] = {&a0, &a1, &a2, &a3, &a4, &a5};
+        _callable->_handle_call_typed(*_entry, args, NULL);
+        return;
+    }
+    PMCList args(6);
+    args[0] = PMC_M(a0);
+    args[1] = PMC_M(a1);
+    args[2] = PMC_M(a2);
+    args[3] = PMC_M(a3);
+    args[4] = PMC_M(a4);
+    args[5] = PMC_M(a5);
+    _callable->_handle_call(_name, PMC_M(args));
+}
+
+/***********************************************************************
+ * Call handle implementations with 7 args
+ **********************************************************************/
+template <typename ReturnType, typename A0, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6>
+ReturnType CallHandle::x(const A0 &a0, const A1 &a1, const A2 &a2, const A3 &a3, const A4 &a4, const A5 &a5, const A6 &a6) const
+{
+    if (_entry->signature() == typeid(ReturnType(*)(A0, A1, A2, A3, A4, A5, A6)))
+    {
+        const void *args[7+1] = {&a0, &a1, &a2, &a3, &a4, &a5, &a6};
+        boost::optional<ReturnType> r;
+        _callable->_handle_call_typed(*_entry, args, &r);
+        return r.get();
+    }
+    PMCList args(7);
+    args[0] = PMC_M(a0);
+    args[1] = PMC_M(a1);
+    args[2] = PMC_M(a2);
+    args[3] = PMC_M(a3);
+    args[4] = PMC_M(a4);
+    args[5] = PMC_M(a5);
+    args[6] = PMC_M(a6);
+    PMCC r = _callable->_handle_call(_name, PMC_M(args));
+    return r.safe_as<ReturnType>();
+}
+
+template <typename A0, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6>
+void CallHandle::x(const A0 &a0, const A1 &a1, const A2 &a2, const A3 &a3, const A4 &a4, const A5 &a5, const A6 &a6) const
+{
+    if (_entry->signature() == typeid(void(*)(A0, A1, A2, A3, A4, A5, A6)))
+    {
+        const void *args[7+1] = {&a0, &a1, &a2, &a3, &a4, &a5, &a6};
+        _callable->_handle_call_typed(*_entry, args, NULL);
+        return;
+    }
+    PMCList args(7);
+    args[0] = PMC_M(a0);
+    args[1] = PMC_M(a1);
+    args[2] = PMC_M(a2);
+    args[3] = PMC_M(a3);
+    args[4] = PMC_M(a4);
+    args[5] = PMC_M(a5);
+    args[6] = PMC_M(a6);
+    _callable->_handle_call(_name, PMC_M(args));
+}
+
+/***********************************************************************
+ * Call handle implementations with 8 args
+ **********************************************************************/
+template <typename ReturnType, typename A0, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7>
+ReturnType CallHandle::x(const A0 &a0, const A1 &a1, const A2 &a2, const A3 &a3, const A4 &a4, const A5 &a5, const A6 &a6, const A7 &a7) const
+{
+    if (_entry->signature() == typeid(ReturnType(*)(A0, A1, A2, A3, A4, A5, A6, A7)))
+    {
+        const void *args[8+1] = {&a0, &a1, &a2, &a3, &a4, &a5, &a6, &a7};
+        boost::optional<ReturnType> r;
+        _callable->_handle_call_typed(*_entry, args, &r);
+        return r.get();
+    }
+    PMCList args(8);
+    args[0] = PMC_M(a0);
+    args[1] = PMC_M(a1);
+    args[2] = PMC_M(a2);
+    args[3] = PMC_M(a3);
+    args[4] = PMC_M(a4);
+    args[5] = PMC_M(a5);
+    args[6] = PMC_M(a6);
+    args[7] = PMC_M(a7);
+    PMCC r = _callable->_handle_call(_name, PMC_M(args));
+    return r.safe_as<ReturnType>();
+}
+
+template <typename A0, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7>
+void CallHandle::x(const A0 &a0, const A1 &a1, const A2 &a2, const A3 &a3, const A4 &a4, const A5 &a5, const A6 &a6, const A7 &a7) const
+{
+    if (_entry->signature() == typeid(void(*)(A0, A1, A2, A3, A4, A5, A6, A7)))
+    {
+        const void *args[8+1] = {&a0, &a1, &a2, &a3, &a4, &a5, &a6, &a7};
+        _callable->_handle_call_typed(*_entry, args, NULL);
+        return;
+    }
+    PMCList args(8);
+    args[0] = PMC_M(a0);
+    args[1] = PMC_M(a1);
+    args[2] = PMC_M(a2);
+    args[3] = PMC_M(a3);
+    args[4] = PMC_M(a4);
+    args[5] = PMC_M(a5);
+    args[6] = PMC_M(a6);
+    args[7] = PMC_M(a7);
+    _callable->_handle_call(_name, PMC_M(args));
+}
+
+/***********************************************************************
+ * Call handle implementations with 9 args
+ **********************************************************************/
+template <typename ReturnType, typename A0, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8>
+ReturnType CallHandle::x(const A0 &a0, const A1 &a1, const A2 &a2, const A3 &a3, const A4 &a4, const A5 &a5, const A6 &a6, const A7 &a7, const A8 &a8) const
+{
+    if (_entry->signature() == typeid(ReturnType(*)(A0, A1, A2, A3, A4, A5, A6, A7, A8)))
+    {
+        const void *args[9+1] = {&a0, &a1, &a2, &a3, &a4, &a5, &a6, &a7, &a8};
+        boost::optional<ReturnType> r;
+        _callable->_handle_call_typed(*_entry, args, &r);
+        return r.get();
+    }
+    PMCList args(9);
+    args[0] = PMC_M(a0);
+    args[1] = PMC_M(a1);
+    args[2] = PMC_M(a2);
+    args[3] = PMC_M(a3);
+    args[4] = PMC_M(a4);
+    args[5] = PMC_M(a5);
+    args[6] = PMC_M(a6);
+    args[7] = PMC_M(a7);
+    args[8] = PMC_M(a8);
+    PMCC r = _callable->_handle_call(_name, PMC_M(args));
+    return r.safe_as<ReturnType>();
+}
+
+template <typename A0, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8>
+void CallHandle::x(const A0 &a0, const A1 &a1, const A2 &a2, const A3 &a3, const A4 &a4, const A5 &a5, const A6 &a6, const A7 &a7, const A8 &a8) const
+{
+    if (_entry->signature() == typeid(void(*)(A0, A1, A2, A3, A4, A5, A6, A7, A8)))
+    {
+        const void *args[9+1] = {&a0, &a1, &a2, &a3, &a4, &a5, &a6, &a7, &a8};
+        _callable->_handle_call_typed(*_entry, args, NULL);
+        return;
+    }
+    PMCList args(9);
+    args[0] = PMC_M(a0);
+    args[1] = PMC_M(a1);
+    args[2] = PMC_M(a2);
+    args[3] = PMC_M(a3);
+    args[4] = PMC_M(a4);
+    args[5] = PMC_M(a5);
+    args[6] = PMC_M(a6);
+    args[7] = PMC_M(a7);
+    args[8] = PMC_M(a8);
+    _callable->_handle_call(_name, PMC_M(args));
+}
+
+/***********************************************************************
+ * Call handle implementations with 10 args
+ **********************************************************************/
+template <typename ReturnType, typename A0, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9>
+ReturnType CallHandle::x(const A0 &a0, const A1 &a1, const A2 &a2, const A3 &a3, const A4 &a4, const A5 &a5, const A6 &a6, const A7 &a7, const A8 &a8, const A9 &a9) const
+{
+    if (_entry->signature() == typeid(ReturnType(*)(A0, A1, A2, A3, A4, A5, A6, A7, A8, A9)))
+    {
+        const void *args[10+1] = {&a0, &a1, &a2, &a3, &a4, &a5, &a6, &a7, &a8, &a9};
+        boost::optional<ReturnType> r;
+        _callable->_handle_call_typed(*_entry, args, &r);
+        return r.get();
+    }
+    PMCList args(10);
+    args[0] = PMC_M(a0);
+    args[1] = PMC_M(a1);
+    args[2] = PMC_M(a2);
+    args[3] = PMC_M(a3);
+    args[4] = PMC_M(a4);
+    args[5] = PMC_M(a5);
+    args[6] = PMC_M(a6);
+    args[7] = PMC_M(a7);
+    args[8] = PMC_M(a8);
+    args[9] = PMC_M(a9);
+    PMCC r = _callable->_handle_call(_name, PMC_M(args));
+    return r.safe_as<ReturnType>();
+}
+
+template <typename A0, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9>
+void CallHandle::x(const A0 &a0, const A1 &a1, const A2 &a2, const A3 &a3, const A4 &a4, const A5 &a5, const A6 &a6, const A7 &a7, const A8 &a8, const A9 &a9) const
+{
+    if (_entry->signature() == typeid(void(*)(A0, A1, A2, A3, A4, A5, A6, A7, A8, A9)))
+    {
+        const void *args[10+1] = {&a0, &a1, &a2, &a3, &a4, &a5, &a6, &a7, &a8, &a9};
+        _callable->_handle_call_typed(*_entry, args, NULL);
+        return;
+    }
+    PMCList args(10);
+    args[0] = PMC_M(a0);
+    args[1] = PMC_M(a1);
+    args[2] = PMC_M(a2);
+    args[3] = PMC_M(a3);
+    args[4] = PMC_M(a4);
+    args[5] = PMC_M(a5);
+    args[6] = PMC_M(a6);
+    args[7] = PMC_M(a7);
+    args[8] = PMC_M(a8);
+    args[9] = PMC_M(a9);
+    _callable->_handle_call(_name, PMC_M(args));
+}
+
 } //namespace gras
 
 #endif /*INCLUDED_GRAS_DETAIL_CALLABLE_HPP*/
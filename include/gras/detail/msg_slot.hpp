@@ -0,0 +1,191 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#ifndef INCLUDED_GRAS_DETAIL_MSG_SLOT_HPP
+#define INCLUDED_GRAS_DETAIL_MSG_SLOT_HPP
+
+#include <gras/gras.hpp>
+#include <PMC/PMC.hpp>
+#include <boost/detail/atomic_count.hpp>
+#include <boost/intrusive_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+#include <boost/enable_shared_from_this.hpp>
+#include <boost/type_traits/aligned_storage.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/thread/mutex.hpp>
+#include <typeinfo>
+#include <vector>
+#include <new>
+
+namespace gras
+{
+
+/*!
+ * A msg slot carries one typed message without PMC boxing.
+ * Slots come from a per-output pool and are reference counted,
+ * so a message fanned out to many consumers is never copied.
+ * The last reference returns the slot to its pool.
+ */
+struct MsgSlot
+{
+    MsgSlot(void):
+        count(0)
+    {}
+
+    virtual ~MsgSlot(void){}
+
+    //! The type of the value held in this slot
+    virtual const std::type_info &type(void) const = 0;
+
+    /*!
+     * Box a copy of the value for the PMC message API.
+     * The value is not written again until the slot is released,
+     * so consumers of a fanned out slot may box it concurrently.
+     */
+    virtual PMCC to_pmc(void) const = 0;
+
+    //! Destroy the value and return the slot to its pool
+    virtual void release(void) = 0;
+
+    boost::detail::atomic_count count;
+};
+
+typedef boost::intrusive_ptr<MsgSlot> MsgSlotPtr;
+
+GRAS_FORCE_INLINE void intrusive_ptr_add_ref(MsgSlot *slot)
+{
+    ++slot->count;
+}
+
+GRAS_FORCE_INLINE void intrusive_ptr_release(MsgSlot *slot)
+{
+    if GRAS_LIKELY(--slot->count == 0) slot->release();
+}
+
+//! Base type for storing typed pools on a block's output port
+struct MsgSlotPool
+{
+    virtual ~MsgSlotPool(void){}
+};
+
+/*!
+ * The pool that a thread last posted a value type with.
+ * The element is held weakly and compared by owner,
+ * so a new block never matches the entry of a deleted one.
+ */
+struct MsgSlotPoolCache
+{
+    MsgSlotPoolCache(void):
+        port(0)
+    {}
+
+    boost::weak_ptr<ElementImpl> element;
+    size_t port;
+    boost::shared_ptr<MsgSlotPool> pool;
+};
+
+template <typename ValueType> struct MsgSlotPoolT;
+
+template <typename ValueType>
+struct MsgSlotT : MsgSlot
+{
+    GRAS_FORCE_INLINE const ValueType &value(void) const
+    {
+        return *reinterpret_cast<const ValueType *>(storage.address());
+    }
+
+    const std::type_info &type(void) const
+    {
+        return typeid(ValueType);
+    }
+
+    PMCC to_pmc(void) const
+    {
+        return PMC_M(this->value());
+    }
+
+    void release(void)
+    {
+        reinterpret_cast<ValueType *>(storage.address())->~ValueType();
+        boost::shared_ptr<MsgSlotPoolT<ValueType> > p;
+        p.swap(pool);
+        p->put(this);
+    } //the pool may be deleted here, taking this slot with it
+
+    boost::aligned_storage<sizeof(ValueType), boost::alignment_of<ValueType>::value> storage;
+
+    //only held while in use so the pool outlives the slot
+    boost::shared_ptr<MsgSlotPoolT<ValueType> > pool;
+};
+
+/*!
+ * A pool of preallocated slots for one output port and value type.
+ * The owning block takes slots in work, and any consumer thread
+ * puts them back after the last reference is gone.
+ */
+template <typename ValueType>
+struct MsgSlotPoolT : MsgSlotPool, boost::enable_shared_from_this<MsgSlotPoolT<ValueType> >
+{
+    enum {NUM_PREALLOC=16};
+
+    MsgSlotPoolT(void)
+    {
+        for (size_t i = 0; i < NUM_PREALLOC; i++)
+        {
+            free_slots.push_back(new MsgSlotT<ValueType>());
+        }
+    }
+
+    //! Make an empty pool for Block::_get_msg_slot_pool
+    static boost::shared_ptr<MsgSlotPool> make_pool(void)
+    {
+        return boost::shared_ptr<MsgSlotPool>(new MsgSlotPoolT<ValueType>());
+    }
+
+    ~MsgSlotPoolT(void)
+    {
+        for (size_t i = 0; i < free_slots.size(); i++)
+        {
+            delete free_slots[i];
+        }
+    }
+
+    //! Copy the value into a free slot (allocates when the pool is dry)
+    MsgSlotPtr make(const ValueType &value)
+    {
+        MsgSlotT<ValueType> *slot = NULL;
+        {
+            boost::mutex::scoped_lock l(mutex);
+            if GRAS_LIKELY(not free_slots.empty())
+            {
+                slot = free_slots.back();
+                free_slots.pop_back();
+            }
+        }
+        if GRAS_UNLIKELY(slot == NULL) slot = new MsgSlotT<ValueType>();
+        try
+        {
+            new (slot->storage.address()) ValueType(value);
+        }
+        catch (...)
+        {
+            this->put(slot);
+            throw;
+        }
+        slot->pool = this->shared_from_this();
+        return MsgSlotPtr(slot);
+    }
+
+    void put(MsgSlotT<ValueType> *slot)
+    {
+        boost::mutex::scoped_lock l(mutex);
+        free_slots.push_back(slot);
+    }
+
+    boost::mutex mutex;
+    std::vector<MsgSlotT<ValueType> *> free_slots;
+};
+
+} //namespace gras
+
+#endif /*INCLUDED_GRAS_DETAIL_MSG_SLOT_HPP*/
@@ -14,6 +14,12 @@ namespace gras
     %ignore Element::set_container;
     %ignore Callable::x;
     %ignore Callable::register_call;
+    %ignore Callable::publish_call;
+    %ignore Callable::get_call_handle;
+    %ignore Callable::_handle_call_typed;
+    %ignore Callable::call_async;
+    %ignore Callable::_handle_call_async;
+    %ignore CallHandle;
 }
 
 ////////////////////////////////////////////////////////////////////////
@@ -5,6 +5,7 @@
 
 #include <gras/gras.hpp>
 #include <gras/element.hpp>
+#include <gras/call_future.hpp>
 #include <PMC/PMC.hpp>
 #include <vector>
 #include <string>
@@ -24,11 +25,68 @@ namespace gras
  * Users may leave this empty unless headers
  * are installed into non-standard directories.
  *
+ * Compiled bitcode is cached on disk, keyed by a hash of the source,
+ * the flags, the compiler version, the GRAS version, and the stamp
+ * of the GRAS library, so that loading the same source again
+ * skips the compiler. Each entry records the size and modification
+ * time of the headers that the source included when compiled,
+ * so that changed headers miss the cache, and a cached bitcode
+ * that fails to load is discarded and compiled again.
+ * The cache lives in the GRAS_JIT_CACHE directory when set,
+ * and otherwise in ~/.gras/jit_cache. Set GRAS_JIT_CACHE
+ * to an empty string to disable the cache. The cache is bounded
+ * to 256 MB, the least recently used entries are removed first.
+ *
  * \param source C++ source code in a string
  * \param flags optional compiler flags
  */
 GRAS_API void jit_factory(const std::string &source, const std::vector<std::string> &flags);
 
+/*!
+ * Run the just in time factory in a background thread.
+ * The calling thread can go on with other setup while clang compiles;
+ * wait on the future before making elements from the compiled source.
+ * Errors from the compilation are thrown by the future's get().
+ *
+ * \param source C++ source code in a string
+ * \param flags optional compiler flags
+ * \return a future that completes when the factory is loaded
+ */
+GRAS_API CallFuture jit_factory_async(const std::string &source, const std::vector<std::string> &flags);
+
+/*!
+ * Run the just in time factory on many sources at once.
+ * The sources compile in parallel clang processes,
+ * and the compiled sources load into the factory together.
+ * When any of the sources fails to compile, nothing is loaded,
+ * and the error has the compiler diagnostics of every failed source.
+ *
+ * \param sources a list of C++ source code strings
+ * \param flags optional compiler flags for all of the sources
+ */
+GRAS_API void jit_factory_batch(const std::vector<std::string> &sources, const std::vector<std::string> &flags);
+
+/*!
+ * Load a module library into the element factory.
+ *
+ * Modules in the search paths do not need this:
+ * a module with a manifest loads on the first make() of one of its paths,
+ * and a module without a manifest loads along with GRAS.
+ * The manifest is a file next to the module named <module>.manifest,
+ * with one factory path per line, and # for comment lines.
+ *
+ * A manifest that is empty or unreadable is ignored,
+ * and the module loads along with GRAS.
+ *
+ * Use this to load a module from elsewhere,
+ * or to get the factory paths for the manifest of a module.
+ * A module that was already loaded returns the paths from its first load.
+ *
+ * \param path the file path of the module library
+ * \return the factory paths that the module registered
+ */
+GRAS_API std::vector<std::string> load_module(const std::string &path);
+
 /***********************************************************************
  * Register API - don't look here, template magic, not helpful
  * Example register a factory function:
@@ -4,17 +4,42 @@
 #define INCLUDED_GRAS_TAG_ITER_HPP
 
 #include <gras/gras.hpp>
+#include <gras/tags.hpp>
 #include <boost/range.hpp> //iterator range
-#include <vector>
+#include <boost/circular_buffer.hpp>
+#include <boost/iterator/filter_iterator.hpp>
 
 namespace gras
 {
 
-    //! forward declared Tag type
-    struct Tag;
+    /*!
+     * Iterator return type stl and boost compliant.
+     * This is a random access view into the tag storage,
+     * which is sorted by offset and held in a ring buffer.
+     */
+    typedef boost::iterator_range<boost::circular_buffer<Tag>::const_iterator> TagIter;
 
-    //! Iterator return type stl and boost compliant
-    typedef boost::iterator_range<std::vector<Tag>::const_iterator> TagIter;
+    //! Predicate to match stream tags by the interned key
+    struct TagKeyMatch
+    {
+        TagKeyMatch(const TagKey &key = TagKey()):
+            key(key)
+        {}
+
+        GRAS_FORCE_INLINE bool operator()(const Tag &tag) const
+        {
+            return tag.object.is<StreamTag>() and tag.object.as<StreamTag>().get_key_id() == key;
+        }
+
+        TagKey key;
+    };
+
+    /*!
+     * Iterator return type for tags filtered by key.
+     * This is a forward view into the tag storage,
+     * which only visits stream tags with a matching key.
+     */
+    typedef boost::iterator_range<boost::filter_iterator<TagKeyMatch, TagIter::const_iterator> > KeyedTagIter;
 
 } //namespace gras
 
@@ -7,6 +7,7 @@
 #include <gras/sbuffer.hpp>
 #include <boost/operators.hpp>
 #include <PMC/PMC.hpp>
+#include <string>
 
 namespace gras
 {
@@ -42,6 +43,44 @@ struct GRAS_API Tag : boost::less_than_comparable<Tag>
 GRAS_API bool operator<(const Tag &lhs, const Tag &rhs);
 GRAS_API bool operator==(const Tag &lhs, const Tag &rhs);
 
+/*!
+ * A tag key is an interned stream tag key.
+ * A global symbol table maps each unique key to a small integer,
+ * so that matching keys is an integer compare and not a PMC compare.
+ * Keys are usually strings, however any PMC key is supported.
+ * The null key is always interned as id 0.
+ */
+struct GRAS_API TagKey
+{
+    //! Make a null tag key
+    TagKey(void);
+
+    //! Intern a key object (usually a string)
+    TagKey(const PMCC &key);
+
+    //! Intern a key from a string
+    TagKey(const std::string &key);
+
+    //! Intern a key from a string
+    TagKey(const char *key);
+
+    //! Get the key object that this key was interned from
+    PMCC key(void) const;
+
+    //! The interned symbol id
+    size_t id;
+};
+
+GRAS_FORCE_INLINE bool operator==(const TagKey &lhs, const TagKey &rhs)
+{
+    return lhs.id == rhs.id;
+}
+
+GRAS_FORCE_INLINE bool operator!=(const TagKey &lhs, const TagKey &rhs)
+{
+    return lhs.id != rhs.id;
+}
+
 /*!
  * A stream tag is a commonly used structure
  * used to decorate a stream item with metadata.
@@ -59,11 +98,28 @@ struct GRAS_API StreamTag
     //! A symbolic name identifying the type of tag
     PMCC key;
 
+    /*!
+     * Get the interned key, used for fast key matching.
+     * The constructor interns the key once; when the key member
+     * is reassigned afterwards, the new key is interned on each call.
+     */
+    GRAS_FORCE_INLINE TagKey get_key_id(void) const
+    {
+        if GRAS_LIKELY(key.get() == _interned_key.get()) return _key_id;
+        return TagKey(key);
+    }
+
     //! The value of this tag -> the sample metadata
     PMCC val;
 
     //! The optional source ID -> something unique
     PMCC src;
+
+private:
+    //the key that _key_id was interned from,
+    //held so that a reassigned key cannot reuse its address
+    PMCC _interned_key;
+    TagKey _key_id;
 };
 
 GRAS_API bool operator==(const StreamTag &lhs, const StreamTag &rhs);
@@ -93,6 +149,29 @@ struct GRAS_API PacketMsg
 
 GRAS_API bool operator==(const PacketMsg &lhs, const PacketMsg &rhs);
 
+/*!
+ * A packet record is a view of one record in a packet stream.
+ * Packet streams carry variable length records inside the
+ * stream buffers, rather than one message per packet.
+ * The memory belongs to the input buffer, and is only
+ * valid for the duration of the call to work().
+ */
+struct GRAS_API PacketRecord
+{
+    PacketRecord(void):
+        data(NULL), length(0), meta(0)
+    {}
+
+    //! Pointer to the payload bytes
+    const void *data;
+
+    //! The length of the payload in bytes
+    size_t length;
+
+    //! User metadata that was posted with the record
+    unsigned meta;
+};
+
 } //namespace gras
 
 #endif /*INCLUDED_GRAS_TAGS_HPP*/
@@ -65,6 +65,43 @@ struct GRAS_API TopBlock : HierBlock
      * \return formatted result of the query
      */
     virtual std::string query(const std::string &args);
+
+    /*!
+     * Capture the scheduler events of all blocks for a while.
+     * Work calls, message handlers, buffer posts and returns,
+     * and block state changes are recorded per thread.
+     * This call blocks for the duration of the capture,
+     * which is limited to 10 seconds.
+     * Each thread records into a fixed size buffer that fills
+     * and then drops further events; it does not wrap around.
+     * The number of dropped events is reported per thread.
+     * \param seconds the duration of the capture in seconds
+     * \return the events in the Chrome trace event JSON format
+     */
+    virtual std::string capture_trace(const double seconds);
+
+    /*!
+     * Start a web server for the query interface.
+     * The server runs in its own threads, and serves
+     * the query web assets and the query paths over http.
+     * The stats of the requested blocks are streamed as server sent
+     * events on /stats.events, sending only the blocks that changed.
+     * A running server is replaced by the new one.
+     *
+     * The query paths can make calls into the blocks,
+     * and the server has no authentication,
+     * so it only listens on the loopback interface by default.
+     *
+     * \param port the tcp port to listen on, or 0 for any free port
+     * \param assets_dir the directory with the query web assets
+     * \param bind_address the address to listen on, empty for all interfaces;
+     * a name listens on every address that it resolves to
+     * \return the tcp port that the server listens on
+     */
+    unsigned short start_query_server(const unsigned short port, const std::string &assets_dir, const std::string &bind_address = "127.0.0.1");
+
+    //! Stop the web server for the query interface
+    void stop_query_server(void);
 };
 
 } //namespace gras
@@ -18,6 +18,7 @@ Block::Block(const std::string &name):
     //create non-actor containers
     (*this)->block_data.reset(new BlockData());
     (*this)->block_data->block = this;
+    (*this)->block_data->cancel_token = CancelToken::make();
     (*this)->worker.reset(new Apology::Worker());
 
     //create actor and init members
@@ -26,6 +27,11 @@ Block::Block(const std::string &name):
 
     //setup some state variables
     (*this)->block_data->block_state = BLOCK_STATE_INIT;
+    (*this)->block_data->message_only = false;
+    (*this)->block_data->latency_tracking = false;
+    (*this)->block_data->perf_counters = false;
+    (*this)->block_data->work_origin_time = 0;
+    (*this)->block_data->stats_publish_time = 0;
 }
 
 Block::~Block(void)
@@ -170,6 +176,11 @@ void Block::commit_config(void)
     }
 }
 
+const CancelToken &Block::get_cancel_token(void) const
+{
+    return (*this)->block_data->cancel_token;
+}
+
 void Block::notify_active(void)
 {
     //NOP
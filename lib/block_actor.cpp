@@ -3,6 +3,7 @@
 #include <gras/thread_pool.hpp>
 #include <gras_impl/block_actor.hpp>
 #include <Theron/Framework.h>
+#include <boost/thread/tss.hpp>
 #include <iostream>
 #include <set>
 #include <map>
@@ -63,6 +64,36 @@ BlockActor *BlockActor::make(const ThreadPool &tp)
     }
 }
 
+/***********************************************************************
+ * Task scope - the block data of the task on this thread
+ **********************************************************************/
+static void null_cleanup(const BlockData *){}
+
+static boost::thread_specific_ptr<const BlockData> &get_task_data(void)
+{
+    static boost::thread_specific_ptr<const BlockData> task_data(&null_cleanup);
+    return task_data;
+}
+
+TaskScope::TaskScope(const BlockData *data):
+    prev(get_task_data().get())
+{
+    get_task_data().reset(data);
+}
+
+TaskScope::~TaskScope(void)
+{
+    get_task_data().reset(prev);
+}
+
+bool TaskScope::active(const BlockData *data)
+{
+    return get_task_data().get() == data;
+}
+
+/***********************************************************************
+ * Block actor constructor
+ **********************************************************************/
 BlockActor::BlockActor(const ThreadPool &tp):
     Theron::Actor(*tp)
 {
@@ -57,6 +57,13 @@ void BlockActor::handle_top_alloc(const TopAllocMessage &, const Theron::Address
 {
     MESSAGE_TRACER();
 
+    //a message-only block never produces stream items
+    if (data->message_only)
+    {
+        this->Send(0, from); //ACK
+        return;
+    }
+
     //allocate output buffers which will also wake up the task
     const size_t num_outputs = worker->get_num_outputs();
     for (size_t i = 0; i < num_outputs; i++)
@@ -20,7 +20,8 @@ void BlockActor::handle_callable(
     //call into the handler overload to do the property access
     try
     {
-        reply.ret = data->block->_handle_call_ts(message.key, message.args);
+        if (message.entry != NULL) message.entry->call_typed(message.typed_args, message.typed_ret);
+        else reply.ret = data->block->_handle_call_ts(message.key, message.args);
     }
     catch (const std::exception &e)
     {
@@ -31,8 +32,13 @@ void BlockActor::handle_callable(
         reply.error = "unknown error";
     }
 
-    //send the reply
-    this->Send(reply, from); //ACK
+    //complete the future or send the reply
+    if (message.future)
+    {
+        if (reply.error.empty()) message.future->set_value(reply.ret);
+        else message.future->set_error(reply.error);
+    }
+    else this->Send(reply, from); //ACK
 
     //work could have been skipped by a high prio msg
     //forcefully kick the task to recheck in a new call
@@ -66,15 +72,11 @@ struct CallableReceiver : Theron::Receiver
 /***********************************************************************
  * Handle the get and set calls from the user's call-stack
  **********************************************************************/
-PMCC Block::_handle_call(const std::string &key, const PMCC &args)
+static PMCC block_call(BlockActor &actor, CallableMessage &message)
 {
     CallableReceiver receiver;
-    CallableMessage message;
-    boost::shared_ptr<BlockActor> actor = (*this)->block_actor;
-    message.prio_token = actor->prio_token;
-    message.key = key;
-    message.args = args;
-    actor->GetFramework().Send(message, receiver.GetAddress(), actor->GetAddress());
+    message.prio_token = actor.prio_token;
+    actor.GetFramework().Send(message, receiver.GetAddress(), actor.GetAddress());
     receiver.Wait();
     if (not receiver.message.error.empty())
     {
@@ -82,3 +84,34 @@ PMCC Block::_handle_call(const std::string &key, const PMCC &args)
     }
     return receiver.message.ret;
 }
+
+PMCC Block::_handle_call(const std::string &key, const PMCC &args)
+{
+    CallableMessage message;
+    message.key = key;
+    message.args = args;
+    return block_call(*(*this)->block_actor, message);
+}
+
+CallFuture Block::_handle_call_async(const std::string &key, const PMCC &args)
+{
+    CallFuture future;
+    future.reset(new CallFutureImpl(key));
+    CallableMessage message;
+    boost::shared_ptr<BlockActor> actor = (*this)->block_actor;
+    message.prio_token = actor->prio_token;
+    message.key = key;
+    message.args = args;
+    message.future = future;
+    actor->GetFramework().Send(message, Theron::Address::Null(), actor->GetAddress());
+    return future;
+}
+
+void Block::_handle_call_typed(CallableRegistryEntry &entry, const void *const *args, void *ret)
+{
+    CallableMessage message;
+    message.entry = &entry;
+    message.typed_args = args;
+    message.typed_ret = ret;
+    block_call(*(*this)->block_actor, message);
+}
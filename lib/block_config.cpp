@@ -9,6 +9,9 @@ GlobalBlockConfig::GlobalBlockConfig(void)
     maximum_output_items = 0;
     buffer_affinity = -1;
     interruptible_work = false;
+    message_only = false;
+    latency_tracking = false;
+    perf_counters = false;
 }
 
 void GlobalBlockConfig::merge(const GlobalBlockConfig &config)
@@ -31,6 +34,18 @@ void GlobalBlockConfig::merge(const GlobalBlockConfig &config)
         this->interruptible_work = config.interruptible_work;
     }
 
+    //overwrite with config's latency tracking setting if not set
+    if (this->latency_tracking == false)
+    {
+        this->latency_tracking = config.latency_tracking;
+    }
+
+    //overwrite with config's hardware counters setting if not set
+    if (this->perf_counters == false)
+    {
+        this->perf_counters = config.perf_counters;
+    }
+
     //overwrite with config's thread pool for actor if not set
     if (not this->thread_pool)
     {
@@ -45,6 +60,9 @@ InputPortConfig::InputPortConfig(void)
     maximum_items = 0;
     inline_buffer = false;
     preload_items = 0;
+    maximum_msgs = 0;
+    packet_stream = false;
+    consume_all_tags = true;
 }
 
 OutputPortConfig::OutputPortConfig(void)
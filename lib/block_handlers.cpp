@@ -1,8 +1,6 @@
 // Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
 
 #include <gras_impl/block_actor.hpp>
-#include <boost/make_shared.hpp>
-#include <boost/bind.hpp>
 
 using namespace gras;
 
@@ -19,6 +17,8 @@ void BlockActor::handle_top_active(
         data->stats.start_time = time_now();
     }
     data->block_state = BLOCK_STATE_LIVE;
+    trace_instant("state_live", this);
+    this->publish_stats();
 
     this->Send(0, from); //ACK
 
@@ -55,11 +55,7 @@ void BlockActor::handle_top_token(
 
         //TODO, schedule this message as a pre-allocation message
         //tell the upstream about the input requirements
-        OutputHintMessage output_hints;
-        output_hints.reserve_bytes = data->input_configs[i].reserve_items*data->input_configs[i].item_size;
-        output_hints.token = data->input_tokens[i];
-        worker->post_upstream(i, output_hints);
-
+        this->post_input_hint(i);
     }
 
     //create output token
@@ -86,6 +82,32 @@ void BlockActor::handle_top_config(
 
     //merge in the non-defaults
     data->block->global_config().merge(message.config);
+    data->message_only = data->block->global_config().message_only;
+    data->latency_tracking = data->block->global_config().latency_tracking;
+    data->perf_counters = data->block->global_config().perf_counters;
+    data->stats.perf_enabled = data->perf_counters? 1 : 0;
+
+    //message-only work always sees empty stream ports
+    if (data->message_only)
+    {
+        data->num_input_msgs_read.assign(data->num_input_msgs_read.size(), 0);
+        data->input_items.min() = 0;
+        data->input_items.max() = 0;
+        for (size_t i = 0; i < data->input_items.size(); i++)
+        {
+            data->input_items.vec()[i] = NULL;
+            data->input_items[i].get() = NULL;
+            data->input_items[i].size() = 0;
+        }
+        data->output_items.min() = 0;
+        data->output_items.max() = 0;
+        for (size_t i = 0; i < data->output_items.size(); i++)
+        {
+            data->output_items.vec()[i] = NULL;
+            data->output_items[i].get() = NULL;
+            data->output_items[i].size() = 0;
+        }
+    }
 
     //overwrite with global config only if maxium_items is not set (zero)
     for (size_t i = 0; i < data->output_configs.size(); i++)
@@ -99,23 +121,17 @@ void BlockActor::handle_top_config(
     this->Send(0, from); //ACK
 }
 
-void BlockActor::handle_top_thread_group(
-    const TopThreadMessage &message,
+void BlockActor::handle_top_cancel(
+    const TopCancelMessage &message,
     const Theron::Address from
 ){
     MESSAGE_TRACER();
 
-    //store the topology's thread group
-    //erase any potentially old lingering threads
-    //spawn a new thread if this block is a source
-    data->thread_group = message.thread_group;
-    data->interruptible_thread.reset(); //erase old one
-    if (data->block->global_config().interruptible_work)
-    {
-        data->interruptible_thread = boost::make_shared<InterruptibleThread>(
-            data->thread_group, boost::bind(&BlockActor::task_work, this)
-        );
-    }
+    //store the topology's cancel token:
+    //work runs directly in this thread pool,
+    //and blocking work waits on this token,
+    //which the top block cancels on stop()
+    data->cancel_token = message.cancel_token;
 
     this->Send(0, from); //ACK
 }
@@ -128,38 +144,71 @@ void BlockActor::handle_self_kick(
     this->task_main();
 }
 
-void BlockActor::handle_get_stats(
-    const GetStatsMessage &,
-    const Theron::Address from
-){
-    MESSAGE_TRACER();
-
+void BlockActor::publish_stats(void)
+{
     //instantaneous states we update here,
     //and not interleaved with the rest of the code
     const size_t num_inputs = worker->get_num_inputs();
     data->stats.items_enqueued.resize(num_inputs);
     data->stats.tags_enqueued.resize(num_inputs);
     data->stats.msgs_enqueued.resize(num_inputs);
+    data->stats.msgs_high_water.resize(num_inputs);
     for (size_t i = 0; i < num_inputs; i++)
     {
         data->stats.items_enqueued[i] = data->input_queues.get_items_enqueued(i);
         data->stats.tags_enqueued[i] = data->input_tags[i].size();
         data->stats.msgs_enqueued[i] = data->input_msgs[i].size();
+        data->stats.msgs_high_water[i] = data->input_msgs[i].high_water;
     }
+    if (data->latency_tracking)
+    {
+        data->stats.latency_samples.resize(num_inputs);
+        #define my_latency_percentiles(which) { \
+            data->stats.which ## _latency_p50.resize(num_inputs); \
+            data->stats.which ## _latency_p90.resize(num_inputs); \
+            data->stats.which ## _latency_p99.resize(num_inputs); \
+            data->stats.which ## _latency_max.resize(num_inputs); \
+            for (size_t i = 0; i < num_inputs; i++) { \
+                const LogHistogram &h = data->input_ ## which ## _latency[i]; \
+                data->stats.which ## _latency_p50[i] = h.percentile(0.50); \
+                data->stats.which ## _latency_p90[i] = h.percentile(0.90); \
+                data->stats.which ## _latency_p99[i] = h.percentile(0.99); \
+                data->stats.which ## _latency_max[i] = h.max; \
+            } \
+        }
+        my_latency_percentiles(queue)
+        my_latency_percentiles(source)
+        for (size_t i = 0; i < num_inputs; i++)
+        {
+            data->stats.latency_samples[i] = data->input_queue_latency[i].count;
+        }
+    }
+    #define my_histogram_percentiles(which) { \
+        const LogHistogram &h = data->which ## _histogram; \
+        data->stats.which ## _p50 = h.percentile(0.50); \
+        data->stats.which ## _p90 = h.percentile(0.90); \
+        data->stats.which ## _p99 = h.percentile(0.99); \
+        data->stats.which ## _max = h.max; \
+    }
+    my_histogram_percentiles(work_time)
+    my_histogram_percentiles(input_items)
+    my_histogram_percentiles(output_items)
     data->stats.actor_queue_depth = this->GetNumQueuedMessages();
     data->stats.bytes_copied = data->input_queues.bytes_copied;
-    data->stats.inputs_idle = data->input_queues.total_idle_times;
-    data->stats.outputs_idle = data->output_queues.total_idle_times;
-
-    //create the message reply object
-    GetStatsMessage message;
-    message.block_id = data->block->get_uid();
-    message.stats = data->stats;
-    message.stats_time = time_now();
 
-    this->Send(message, from); //ACK
+    //a port that is starved or backpressured right now counts as idle until now
+    const time_ticks_t now = time_now();
+    data->stats.inputs_idle.resize(data->input_queues.total_idle_times.size());
+    for (size_t i = 0; i < data->stats.inputs_idle.size(); i++)
+    {
+        data->stats.inputs_idle[i] = data->input_queues.idle_time(i, now);
+    }
+    data->stats.outputs_idle.resize(data->output_queues.total_idle_times.size());
+    for (size_t i = 0; i < data->stats.outputs_idle.size(); i++)
+    {
+        data->stats.outputs_idle[i] = data->output_queues.idle_time(i, now);
+    }
 
-    //work could have been skipped by a high prio msg
-    //forcefully kick the task to recheck in a new call
-    this->Send(SelfKickMessage(), this->GetAddress());
+    //readers copy the snapshot without messaging this actor
+    data->stats_snapshot.publish(data->stats, now);
 }
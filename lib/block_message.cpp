@@ -8,30 +8,108 @@ using namespace gras;
 
 void Block::post_output_tag(const size_t which_output, const Tag &tag)
 {
-    (*this)->block_data->stats.tags_produced[which_output]++;
-    (*this)->worker->post_downstream(which_output, InputTagMessage(tag));
+    //drop tags that no downstream block subscribes to
+    BlockData &data = *(*this)->block_data;
+    if GRAS_UNLIKELY(not data.output_tag_subscriptions[which_output].wants(tag))
+    {
+        data.stats.tags_dropped[which_output]++;
+        return;
+    }
+
+    data.stats.tags_produced[which_output]++;
+
+    //tags from the block's own task are batched and sent with the output buffer,
+    //from anywhere else the pending batch is not safe to touch, send right away
+    if GRAS_LIKELY(TaskScope::active(&data))
+    {
+        data.output_tags[which_output].push_back(tag);
+        return;
+    }
+    InputTagMessage tag_msg;
+    tag_msg.tags.push_back(tag);
+    (*this)->worker->post_downstream(which_output, tag_msg);
 }
 
-void Block::_post_output_msg(const size_t which_output, const PMCC &msg)
+void Block::_post_output_msg(const size_t which_output, const PMCC &msg, const MsgSlotPtr &slot)
 {
     (*this)->block_data->stats.msgs_produced[which_output]++;
-    (*this)->worker->post_downstream(which_output, InputMsgMessage(msg));
+    (*this)->worker->post_downstream(which_output, InputMsgMessage(msg, slot));
+}
+
+boost::shared_ptr<MsgSlotPool> Block::_get_msg_slot_pool(const size_t which_output, const std::type_info &type, boost::shared_ptr<MsgSlotPool>(*make_pool)(void))
+{
+    //messages may be posted from threads other than the actor's
+    BlockData &data = *(*this)->block_data;
+    boost::mutex::scoped_lock l(data.output_msg_pools_mutex);
+
+    //a port almost always carries a single type, search linearly
+    std::vector<BlockData::MsgSlotPoolEntry> &pools = data.output_msg_pools[which_output];
+    for (size_t j = 0; j < pools.size(); j++)
+    {
+        if GRAS_LIKELY(*pools[j].first == type) return pools[j].second;
+    }
+    pools.push_back(BlockData::MsgSlotPoolEntry(&type, make_pool()));
+    return pools.back().second;
+}
+
+SBuffer Block::get_output_msg_buffer(const size_t which_output, const size_t num_bytes)
+{
+    BlockData &data = *(*this)->block_data;
+    boost::shared_ptr<MsgBufferPool> &pool = data.output_msg_buffer_pools[which_output];
+    if GRAS_UNLIKELY(not pool) pool.reset(new MsgBufferPool(this->global_config().buffer_affinity));
+
+    SBuffer buff;
+    if GRAS_LIKELY(pool->get(num_bytes, buff)) data.stats.msg_buffers_hit[which_output]++;
+    else data.stats.msg_buffers_miss[which_output]++;
+    return buff;
 }
 
 TagIter Block::get_input_tags(const size_t which_input)
 {
-    const std::vector<Tag> &input_tags = (*this)->block_data->input_tags[which_input];
-    return TagIter(input_tags.begin(), input_tags.end());
+    return (*this)->block_data->input_tags[which_input].all();
+}
+
+TagIter Block::get_input_tags(const size_t which_input, const item_index_t begin, const item_index_t end)
+{
+    return (*this)->block_data->input_tags[which_input].range(begin, end);
+}
+
+KeyedTagIter Block::get_input_tags(const size_t which_input, const TagKey &key, const item_index_t begin, const item_index_t end)
+{
+    const TagIter range = (*this)->block_data->input_tags[which_input].range(begin, end);
+    const TagKeyMatch match(key);
+    return KeyedTagIter(
+        boost::make_filter_iterator(match, range.begin(), range.end()),
+        boost::make_filter_iterator(match, range.end(), range.end()));
 }
 
 PMCC Block::pop_input_msg(const size_t which_input)
 {
-    std::vector<PMCC> &input_msgs = (*this)->block_data->input_msgs[which_input];
+    const MsgQueue &input_msgs = (*this)->block_data->input_msgs[which_input];
     size_t &num_read = (*this)->block_data->num_input_msgs_read[which_input];
     if (num_read >= input_msgs.size()) return PMCC();
-    PMCC p = input_msgs[num_read++];
+    const MsgEntry &entry = input_msgs[num_read++];
+    (*this)->block_data->stats.msgs_consumed[which_input]++;
+    if GRAS_UNLIKELY(entry.slot) return entry.slot->to_pmc();
+    return entry.msg;
+}
+
+bool Block::_peek_input_msg(const size_t which_input, const PMCC *&msg, const MsgSlot *&slot)
+{
+    //entries stay in the queue until after work, so pointers are stable
+    const MsgQueue &input_msgs = (*this)->block_data->input_msgs[which_input];
+    const size_t num_read = (*this)->block_data->num_input_msgs_read[which_input];
+    if (num_read >= input_msgs.size()) return false;
+    const MsgEntry &entry = input_msgs[num_read];
+    msg = &entry.msg;
+    slot = entry.slot.get();
+    return true;
+}
+
+void Block::_consume_input_msg(const size_t which_input)
+{
+    (*this)->block_data->num_input_msgs_read[which_input]++;
     (*this)->block_data->stats.msgs_consumed[which_input]++;
-    return p;
 }
 
 void Block::propagate_tags(const size_t i, const TagIter &iter)
@@ -50,8 +128,9 @@ void Block::propagate_tags(const size_t i, const TagIter &iter)
 
 void Block::post_input_tag(const size_t which_input, const Tag &tag)
 {
-    InputTagMessage message(tag);
+    InputTagMessage message;
     message.index = which_input;
+    message.tags.push_back(tag);
     Theron::Actor &actor = *((*this)->block_actor);
     actor.GetFramework().Send(message, Theron::Address::Null(), actor.GetAddress());
 }
@@ -0,0 +1,90 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#include "element_impl.hpp"
+#include <gras_impl/block_actor.hpp>
+#include <gras/block.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/format.hpp>
+#include <stdexcept>
+#include <cstring>
+
+using namespace gras;
+
+/***********************************************************************
+ * Packet stream record format:
+ * A fixed size header followed by the payload,
+ * padded so that the next header is always aligned.
+ **********************************************************************/
+struct PacketRecordHeader
+{
+    boost::uint32_t length; //payload bytes
+    boost::uint32_t meta; //user metadata
+};
+
+static const size_t RECORD_ALIGN = sizeof(PacketRecordHeader);
+
+static GRAS_FORCE_INLINE size_t record_bytes(const size_t length)
+{
+    return sizeof(PacketRecordHeader) + ((length + RECORD_ALIGN - 1) & ~(RECORD_ALIGN - 1));
+}
+
+static GRAS_FORCE_INLINE void check_item_size(const size_t item_size)
+{
+    if GRAS_LIKELY((RECORD_ALIGN % item_size) == 0) return;
+    throw std::invalid_argument(str(boost::format(
+        "packet stream ports need an item size that divides %u bytes, not %u") % RECORD_ALIGN % item_size));
+}
+
+/***********************************************************************
+ * Packet stream API
+ **********************************************************************/
+bool Block::post_output_record(const size_t which_output, const void *payload, const size_t length, const unsigned meta)
+{
+    BlockData &data = *(*this)->block_data;
+    const size_t item_size = data.output_configs[which_output].item_size;
+    check_item_size(item_size);
+
+    //records are never split, the whole record must fit in this buffer
+    const size_t bytes = record_bytes(length);
+    const size_t offset = data.num_output_items_read[which_output]*item_size;
+    const size_t available = data.output_items[which_output].size()*item_size - offset;
+    if GRAS_UNLIKELY(bytes > available)
+    {
+        if (offset != 0) return false; //try again with a fresh buffer
+        throw std::invalid_argument(str(boost::format(
+            "Block::post_output_record(%u): record of %u bytes is larger than the output buffer (%u bytes).\n"
+            "Set the reserve_items on this output port to fit the largest record.") % which_output % bytes % available));
+    }
+
+    char *mem = reinterpret_cast<char *>(data.output_items[which_output].get()) + offset;
+    PacketRecordHeader *header = reinterpret_cast<PacketRecordHeader *>(mem);
+    header->length = boost::uint32_t(length);
+    header->meta = boost::uint32_t(meta);
+    std::memcpy(mem + sizeof(PacketRecordHeader), payload, length);
+    this->produce(which_output, bytes/item_size);
+    return true;
+}
+
+bool Block::pop_input_record(const size_t which_input, PacketRecord &record)
+{
+    BlockData &data = *(*this)->block_data;
+    const size_t item_size = data.input_configs[which_input].item_size;
+    check_item_size(item_size);
+
+    const size_t offset = data.num_input_items_read[which_input]*item_size;
+    const size_t available = data.input_items[which_input].size()*item_size - offset;
+    if (available < sizeof(PacketRecordHeader)) return false;
+
+    const char *mem = reinterpret_cast<const char *>(data.input_items[which_input].get()) + offset;
+    const PacketRecordHeader *header = reinterpret_cast<const PacketRecordHeader *>(mem);
+    const size_t bytes = record_bytes(header->length);
+    if GRAS_UNLIKELY(bytes > available) throw std::runtime_error(str(boost::format(
+        "Block::pop_input_record(%u): truncated record of %u bytes in a %u byte buffer.\n"
+        "Is the upstream producing with post_output_record()?") % which_input % bytes % available));
+
+    record.data = mem + sizeof(PacketRecordHeader);
+    record.length = header->length;
+    record.meta = header->meta;
+    this->consume(which_input, bytes/item_size);
+    return true;
+}
@@ -0,0 +1,76 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#include "element_impl.hpp"
+#include <gras/block.hpp>
+#include <stdexcept>
+
+#ifdef BOOST_MSVC
+#include <intrin.h>
+#endif
+
+using namespace gras;
+
+//the state holds the index of the latest slot and a fresh bit,
+//the fresh bit is set by writers and cleared by the reader
+static const long PARAMS_FRESH = 0x4;
+static const long PARAMS_INDEX = 0x3;
+
+//! Exchange the state with a full memory barrier
+static long params_exchange(volatile long *state, const long value)
+{
+    #ifdef BOOST_MSVC
+    return _InterlockedExchange(state, value);
+    #else
+    long old;
+    do old = *state;
+    while (__sync_val_compare_and_swap(state, old, value) != old);
+    return old;
+    #endif
+}
+
+BlockParamsBase::BlockParamsBase(void):
+    _front(0),
+    _back(2),
+    _state(1)
+{
+    //NOP
+}
+
+BlockParamsBase::~BlockParamsBase(void)
+{
+    //NOP
+}
+
+bool BlockParamsBase::latch(void)
+{
+    if GRAS_LIKELY((_state & PARAMS_FRESH) == 0) return false;
+    _front = size_t(params_exchange(&_state, long(_front)) & PARAMS_INDEX);
+    return true;
+}
+
+void BlockParamsBase::_publish(void)
+{
+    _back = size_t(params_exchange(&_state, long(_back) | PARAMS_FRESH) & PARAMS_INDEX);
+}
+
+void Block::register_params(const std::string &name, BlockParamsBase &params)
+{
+    std::vector<std::pair<std::string, BlockParamsBase *> > &registry = (*this)->block_data->params;
+    for (size_t i = 0; i < registry.size(); i++)
+    {
+        if (registry[i].first == name) throw std::invalid_argument("Block - params already registered for name: " + name);
+    }
+    registry.push_back(std::make_pair(name, &params));
+}
+
+BlockParamsBase &Block::_get_params(const std::string &name, const std::type_info &type)
+{
+    const std::vector<std::pair<std::string, BlockParamsBase *> > &registry = (*this)->block_data->params;
+    for (size_t i = 0; i < registry.size(); i++)
+    {
+        if (registry[i].first != name) continue;
+        if (registry[i].second->type() != type) throw std::invalid_argument("Block - wrong params type for name: " + name);
+        return *registry[i].second;
+    }
+    throw std::invalid_argument("Block - no params registered for name: " + name);
+}
@@ -0,0 +1,90 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#include <gras_impl/call_future.hpp>
+#include <boost/thread/thread_time.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <stdexcept>
+
+using namespace gras;
+
+/***********************************************************************
+ * Call future
+ **********************************************************************/
+CallFuture::CallFuture(void)
+{
+    //NOP
+}
+
+const std::string &CallFuture::name(void) const
+{
+    return (*this)->name;
+}
+
+bool CallFuture::ready(void) const
+{
+    boost::mutex::scoped_lock lock((*this)->mutex);
+    return (*this)->done;
+}
+
+bool CallFuture::wait(const double timeout) const
+{
+    CallFutureImpl &impl = **this;
+    boost::mutex::scoped_lock lock(impl.mutex);
+    if (timeout < 0.0)
+    {
+        while (not impl.done) impl.cond.wait(lock);
+        return true;
+    }
+    const boost::system_time deadline = boost::get_system_time() + boost::posix_time::microseconds(long(timeout*1e6));
+    while (not impl.done)
+    {
+        if (not impl.cond.timed_wait(lock, deadline)) break;
+    }
+    return impl.done;
+}
+
+PMCC CallFuture::get_pmc(void) const
+{
+    this->wait();
+    const CallFutureImpl &impl = **this;
+    if (not impl.error.empty()) throw std::runtime_error(impl.error);
+    return impl.ret;
+}
+
+std::string CallFuture::get_error(void) const
+{
+    this->wait();
+    return (*this)->error;
+}
+
+/***********************************************************************
+ * Call batch
+ **********************************************************************/
+size_t CallBatch::add(const CallFuture &future)
+{
+    _futures.push_back(future);
+    return _futures.size()-1;
+}
+
+size_t CallBatch::size(void) const
+{
+    return _futures.size();
+}
+
+const CallFuture &CallBatch::operator[](const size_t index) const
+{
+    return _futures.at(index);
+}
+
+void CallBatch::wait(void) const
+{
+    std::string errors;
+    for (size_t i = 0; i < _futures.size(); i++)
+    {
+        const std::string error = _futures[i].get_error();
+        if (error.empty()) continue;
+        if (not errors.empty()) errors += "\n";
+        errors += _futures[i].name() + ": " + error;
+    }
+    if (not errors.empty()) throw std::runtime_error("CallBatch - calls failed:\n" + errors);
+}
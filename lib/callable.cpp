@@ -1,6 +1,7 @@
 // Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
 
 #include <gras/callable.hpp>
+#include <gras_impl/call_future.hpp>
 #include <boost/foreach.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/format.hpp>
@@ -54,6 +55,56 @@ PMCC Callable::_handle_call(const std::string &name, const PMCC &args)
     return (*cr)[name]->call(args);
 }
 
+CallFuture Callable::_handle_call_async(const std::string &name, const PMCC &args)
+{
+    //a plain callable has no thread context, so the call completes here
+    CallFuture future;
+    future.reset(new CallFutureImpl(name));
+    try
+    {
+        future->set_value(this->_handle_call(name, args));
+    }
+    catch (const std::exception &e)
+    {
+        future->set_error(e.what());
+    }
+    return future;
+}
+
+void Callable::_handle_call_typed(CallableRegistryEntry &entry, const void *const *args, void *ret)
+{
+    entry.call_typed(args, ret);
+}
+
+CallHandle Callable::get_call_handle(const std::string &name)
+{
+    CallableRegistry *cr = reinterpret_cast<CallableRegistry *>(_call_registry.get());
+    if (cr->count(name) == 0) throw std::invalid_argument("Callable - no method registered for name: " + name);
+    CallHandle handle;
+    handle._callable = this;
+    handle._name = name;
+    handle._entry = (*cr)[name];
+    return handle;
+}
+
+void Callable::_publish_call(const std::string &name, const PMCC &value)
+{
+    CallableRegistry *cr = reinterpret_cast<CallableRegistry *>(_call_registry.get());
+    if (cr->count(name) == 0) throw std::invalid_argument("Callable - no method registered for name: " + name);
+    boost::atomic_store(&(*cr)[name]->published, boost::shared_ptr<const PMCC>(new PMCC(value)));
+}
+
+CallHandle::CallHandle(void):
+    _callable(NULL)
+{
+    //NOP
+}
+
+const std::string &CallHandle::name(void) const
+{
+    return _name;
+}
+
 CallableRegistryEntry::CallableRegistryEntry(void)
 {
     //NOP
@@ -0,0 +1,194 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#include <gras/cancel_token.hpp>
+#include <boost/detail/atomic_count.hpp>
+#include <boost/thread/thread.hpp> //sleep
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <stdexcept>
+
+#if defined(_WIN32) || defined(__WIN32__) || defined(WIN32)
+    #define GRAS_CANCEL_NO_FD
+#else
+    #include <poll.h>
+    #include <unistd.h>
+    #include <fcntl.h>
+    #include <cerrno>
+    #ifdef __linux__
+        #include <sys/eventfd.h>
+        #define GRAS_CANCEL_EVENTFD
+    #endif
+#endif
+
+using namespace gras;
+
+/***********************************************************************
+ * Cancel token guts: a flag, a condition, and a lazy wakeup fd
+ **********************************************************************/
+struct gras::CancelTokenImpl
+{
+    CancelTokenImpl(void):
+        count(0),
+        read_fd(-1),
+        write_fd(-1)
+    {
+        //NOP
+    }
+
+    ~CancelTokenImpl(void)
+    {
+        #ifndef GRAS_CANCEL_NO_FD
+        if (read_fd != -1) close(read_fd);
+        if (write_fd != -1 and write_fd != read_fd) close(write_fd);
+        #endif //GRAS_CANCEL_NO_FD
+    }
+
+    //! create the fd pair on first use (call with lock held)
+    void make_fds(void)
+    {
+        if (read_fd != -1) return;
+        #ifdef GRAS_CANCEL_EVENTFD
+        read_fd = write_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (read_fd == -1) throw std::runtime_error("CancelToken eventfd failed");
+        #elif !defined(GRAS_CANCEL_NO_FD)
+        int fds[2];
+        if (pipe(fds) != 0) throw std::runtime_error("CancelToken pipe failed");
+        read_fd = fds[0];
+        write_fd = fds[1];
+        fcntl(write_fd, F_SETFL, O_NONBLOCK);
+        #endif
+    }
+
+    //! make the fd readable forever (call with lock held)
+    void signal_fds(void)
+    {
+        if (write_fd == -1) return;
+        #ifdef GRAS_CANCEL_EVENTFD
+        const unsigned long long one = 1;
+        const ssize_t ret = write(write_fd, &one, sizeof(one));
+        #elif !defined(GRAS_CANCEL_NO_FD)
+        const char one = 1;
+        const ssize_t ret = write(write_fd, &one, sizeof(one));
+        #endif
+        (void)ret;
+    }
+
+    boost::detail::atomic_count count;
+    boost::mutex mutex;
+    boost::condition_variable cond;
+    int read_fd;
+    int write_fd;
+};
+
+/***********************************************************************
+ * Cancel token implementation
+ **********************************************************************/
+CancelToken::CancelToken(void)
+{
+    //NOP
+}
+
+CancelToken CancelToken::make(void)
+{
+    CancelToken token;
+    token.reset(new CancelTokenImpl());
+    return token;
+}
+
+void CancelToken::cancel(void) const
+{
+    if (not *this) return;
+    boost::mutex::scoped_lock lock((*this)->mutex);
+    if ((*this)->count != 0) return;
+    ++(*this)->count;
+    (*this)->signal_fds();
+    (*this)->cond.notify_all();
+}
+
+bool CancelToken::cancelled(void) const
+{
+    if GRAS_UNLIKELY(not *this) return false;
+    return (*this)->count != 0;
+}
+
+int CancelToken::get_fd(void) const
+{
+    if (not *this) return -1;
+    boost::mutex::scoped_lock lock((*this)->mutex);
+    if ((*this)->read_fd == -1)
+    {
+        (*this)->make_fds();
+        if ((*this)->count != 0) (*this)->signal_fds();
+    }
+    return (*this)->read_fd;
+}
+
+bool CancelToken::wait(const double timeout) const
+{
+    const boost::system_time exit_time = boost::get_system_time() +
+        boost::posix_time::microseconds(long(timeout*1e6));
+
+    //null token, there is nothing to cancel this wait
+    if (not *this)
+    {
+        boost::this_thread::sleep(exit_time);
+        return true;
+    }
+
+    boost::mutex::scoped_lock lock((*this)->mutex);
+    while ((*this)->count == 0)
+    {
+        if (not (*this)->cond.timed_wait(lock, exit_time)) return (*this)->count == 0;
+    }
+    return false;
+}
+
+#ifdef GRAS_CANCEL_NO_FD
+
+bool CancelToken::wait_readable(const int, const double) const
+{
+    throw std::runtime_error("CancelToken::wait_readable not supported on this platform");
+}
+
+bool CancelToken::wait_writable(const int, const double) const
+{
+    throw std::runtime_error("CancelToken::wait_writable not supported on this platform");
+}
+
+#else //GRAS_CANCEL_NO_FD
+
+static bool poll_fd_or_cancel(const CancelToken &token, const int fd, const short events, const double timeout)
+{
+    pollfd fds[2];
+    fds[0].fd = fd;
+    fds[0].events = events;
+    fds[0].revents = 0;
+    fds[1].fd = token.get_fd();
+    fds[1].events = POLLIN;
+    fds[1].revents = 0;
+    const nfds_t nfds = (fds[1].fd == -1)? 1 : 2;
+    const int timeout_ms = (timeout < 0.0)? -1 : int(timeout*1000);
+
+    while (true)
+    {
+        if (token.cancelled()) return false;
+        const int ret = poll(fds, nfds, timeout_ms);
+        if (ret < 0 and errno == EINTR) continue;
+        if (ret < 0) throw std::runtime_error("CancelToken poll failed");
+        if (ret == 0) return false; //timeout
+        if (nfds == 2 and fds[1].revents != 0) return false; //cancelled
+        return fds[0].revents != 0; //ready, or an error for the caller to read
+    }
+}
+
+bool CancelToken::wait_readable(const int fd, const double timeout) const
+{
+    return poll_fd_or_cancel(*this, fd, POLLIN, timeout);
+}
+
+bool CancelToken::wait_writable(const int fd, const double timeout) const
+{
+    return poll_fd_or_cancel(*this, fd, POLLOUT, timeout);
+}
+
+#endif //GRAS_CANCEL_NO_FD
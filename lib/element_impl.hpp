@@ -10,13 +10,15 @@
 #include <gras/element.hpp>
 #include <gras/block.hpp>
 #include <gras_impl/token.hpp>
-#include <gras_impl/interruptible_thread.hpp>
+#include <gras/cancel_token.hpp>
 #include <boost/foreach.hpp>
 #include <map>
 
 namespace gras
 {
 
+struct QueryServer;
+
 struct ElementImpl
 {
     //setup stuff
@@ -36,7 +38,7 @@ struct ElementImpl
     boost::shared_ptr<WeakContainer> weak_self;
 
     //top block stuff
-    SharedThreadGroup thread_group;
+    CancelToken cancel_token;
     Token token;
     GlobalBlockConfig global_config;
 
@@ -49,6 +51,7 @@ struct ElementImpl
     boost::shared_ptr<Apology::Worker> worker;
     boost::shared_ptr<Apology::Topology> topology;
     boost::shared_ptr<Apology::Executor> executor;
+    boost::shared_ptr<QueryServer> query_server;
     boost::shared_ptr<BlockActor> block_actor;
     boost::shared_ptr<BlockData> block_data;
     ThreadPool thread_pool;
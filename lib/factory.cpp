@@ -6,6 +6,7 @@
 #include <boost/thread/mutex.hpp>
 #include <stdexcept>
 #include <iostream>
+#include <vector>
 #include <map>
 
 using namespace gras;
@@ -36,6 +37,29 @@ static FactoryRegistryType &get_factory_registry(void)
 
 static boost::mutex mutex;
 
+//defined in module loader
+bool load_module_for_factory_path(const std::string &path);
+
+//used by module loader to find the paths that a module registered
+std::vector<std::string> get_registered_factory_paths(void)
+{
+    boost::mutex::scoped_lock l(mutex);
+    std::vector<std::string> paths;
+    for (FactoryRegistryType::const_iterator it = get_factory_registry().begin(); it != get_factory_registry().end(); it++)
+    {
+        paths.push_back(it->first);
+    }
+    return paths;
+}
+
+static boost::shared_ptr<FactoryRegistryEntry> find_factory_entry(const std::string &path)
+{
+    boost::mutex::scoped_lock l(mutex);
+    FactoryRegistryType::const_iterator it = get_factory_registry().find(path);
+    if (it == get_factory_registry().end()) return boost::shared_ptr<FactoryRegistryEntry>();
+    return it->second;
+}
+
 void gras::_register_factory(const std::string &path, void *entry)
 {
     boost::mutex::scoped_lock l(mutex);
@@ -48,10 +72,21 @@ void gras::_register_factory(const std::string &path, void *entry)
 
 Element *gras::_handle_make(const std::string &path, const PMCC &args)
 {
-    boost::mutex::scoped_lock l(mutex);
-    if (get_factory_registry().count(path) == 0)
+    boost::shared_ptr<FactoryRegistryEntry> entry = find_factory_entry(path);
+
+    //the module that provides the path loads on first use,
+    //without the lock, because its static constructors register factories;
+    //look again even when this call did not load it, another make()
+    //may have just loaded the same module for one of its other paths
+    if (not entry)
+    {
+        load_module_for_factory_path(path);
+        entry = find_factory_entry(path);
+    }
+
+    if (not entry)
     {
         throw std::invalid_argument("Factory - no function registered for path: " + path);
     }
-    return get_factory_registry()[path]->make(args);
+    return entry->make(args);
 }
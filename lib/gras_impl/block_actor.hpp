@@ -10,12 +10,17 @@
 #include <Apology/Worker.hpp>
 #include <gras_impl/messages.hpp>
 #include <gras_impl/block_data.hpp>
+#include <gras_impl/trace.hpp>
+#include <algorithm>
+#include <vector>
 
 namespace gras
 {
 
 struct BlockActor : Theron::Actor
 {
+    enum {STATS_PUBLISH_RATE=100}; //snapshots per second
+
     static BlockActor *make(const ThreadPool &tp = ThreadPool());
     BlockActor(const ThreadPool &tp);
     ~BlockActor(void);
@@ -35,7 +40,7 @@ struct BlockActor : Theron::Actor
         this->RegisterHandler(this, &BlockActor::handle_top_inert);
         this->RegisterHandler(this, &BlockActor::handle_top_token);
         this->RegisterHandler(this, &BlockActor::handle_top_config);
-        this->RegisterHandler(this, &BlockActor::handle_top_thread_group);
+        this->RegisterHandler(this, &BlockActor::handle_top_cancel);
 
         this->RegisterHandler(this, &BlockActor::handle_input_tag);
         this->RegisterHandler(this, &BlockActor::handle_input_msg);
@@ -49,12 +54,12 @@ struct BlockActor : Theron::Actor
         this->RegisterHandler(this, &BlockActor::handle_output_token);
         this->RegisterHandler(this, &BlockActor::handle_output_check);
         this->RegisterHandler(this, &BlockActor::handle_output_hint);
+        this->RegisterHandler(this, &BlockActor::handle_output_pressure);
         this->RegisterHandler(this, &BlockActor::handle_output_alloc);
         this->RegisterHandler(this, &BlockActor::handle_output_update);
 
         this->RegisterHandler(this, &BlockActor::handle_callable);
         this->RegisterHandler(this, &BlockActor::handle_self_kick);
-        this->RegisterHandler(this, &BlockActor::handle_get_stats);
     }
 
     //handlers
@@ -65,7 +70,7 @@ struct BlockActor : Theron::Actor
     void handle_top_inert(const TopInertMessage &, const Theron::Address);
     void handle_top_token(const TopTokenMessage &, const Theron::Address);
     void handle_top_config(const TopConfigMessage &, const Theron::Address);
-    void handle_top_thread_group(const TopThreadMessage &, const Theron::Address);
+    void handle_top_cancel(const TopCancelMessage &, const Theron::Address);
 
     void handle_input_tag(const InputTagMessage &, const Theron::Address);
     void handle_input_msg(const InputMsgMessage &, const Theron::Address);
@@ -79,31 +84,53 @@ struct BlockActor : Theron::Actor
     void handle_output_token(const OutputTokenMessage &, const Theron::Address);
     void handle_output_check(const OutputCheckMessage &, const Theron::Address);
     void handle_output_hint(const OutputHintMessage &, const Theron::Address);
+    void handle_output_pressure(const OutputPressureMessage &, const Theron::Address);
     void handle_output_alloc(const OutputAllocMessage &, const Theron::Address);
     void handle_output_update(const OutputUpdateMessage &, const Theron::Address);
 
     void handle_callable(const CallableMessage &, const Theron::Address);
     void handle_self_kick(const SelfKickMessage &, const Theron::Address);
-    void handle_get_stats(const GetStatsMessage &, const Theron::Address);
 
     //helpers
     void mark_done(void);
     void task_main(void);
+    void task_msgs(void);
     void input_fail(const size_t index);
     void output_fail(const size_t index);
     void produce(const size_t index, const size_t items);
     void consume(const size_t index, const size_t items);
     void task_kicker(void);
     void update_input_avail(const size_t index);
+    void update_msg_pressure(const size_t index);
     bool is_work_allowed(void);
+    void take_output_tags(const size_t index, std::vector<Tag> &tags);
+    void post_input_hint(const size_t index);
+    void post_output_tags(const size_t index);
+    void update_stats(const time_ticks_t now);
+    void publish_stats(void);
 
     //work helpers
     inline void task_work(void)
     {
+        TraceScope trace("work", this);
+        for (size_t i = 0; i < data->params.size(); i++) data->params[i].second->latch();
         data->block->work(data->input_items, data->output_items);
     }
 };
 
+/*!
+ * Marks the block whose task is running on this thread.
+ * Tags that the task posts are batched with the output buffers,
+ * tags posted from any other thread or handler are sent right away.
+ */
+struct TaskScope
+{
+    TaskScope(const BlockData *data);
+    ~TaskScope(void);
+    static bool active(const BlockData *data);
+    const BlockData *prev;
+};
+
 //-------------- common functions from this BlockActor class ---------//
 
 GRAS_FORCE_INLINE void BlockActor::task_kicker(void)
@@ -119,14 +146,67 @@ GRAS_FORCE_INLINE void BlockActor::update_input_avail(const size_t i)
     data->input_queues.update_has_msg(i, has_input_msgs);
 }
 
+GRAS_FORCE_INLINE void BlockActor::update_msg_pressure(const size_t i)
+{
+    //tell the upstream when the msg queue becomes full or drains
+    MsgQueue &msgs = data->input_msgs[i];
+    const bool full = msgs.full() and data->block_state != BLOCK_STATE_DONE;
+    if GRAS_LIKELY(full == msgs.backpressure) return;
+    msgs.backpressure = full;
+    OutputPressureMessage pressure_msg;
+    pressure_msg.full = full;
+    pressure_msg.token = data->input_tokens[i];
+    worker->post_upstream(i, pressure_msg);
+}
+
+GRAS_FORCE_INLINE void BlockActor::take_output_tags(const size_t i, std::vector<Tag> &tags)
+{
+    //move the pending tags into a message, sorted by offset
+    std::vector<Tag> &pending = data->output_tags[i];
+    if GRAS_LIKELY(pending.empty()) return;
+    for (size_t j = 1; j < pending.size(); j++)
+    {
+        if GRAS_LIKELY(not (pending[j] < pending[j-1])) continue;
+        std::stable_sort(pending.begin(), pending.end());
+        break;
+    }
+    tags.swap(pending);
+}
+
+GRAS_FORCE_INLINE void BlockActor::post_output_tags(const size_t i)
+{
+    //no buffer to carry the pending tags, send them on their own
+    if GRAS_LIKELY(data->output_tags[i].empty()) return;
+    InputTagMessage tag_msg;
+    this->take_output_tags(i, tag_msg.tags);
+    worker->post_downstream(i, tag_msg);
+}
+
+GRAS_FORCE_INLINE void BlockActor::update_stats(const time_ticks_t now)
+{
+    //publish the stats snapshot at most every interval
+    if GRAS_LIKELY(now < data->stats_publish_time) return;
+    data->stats_publish_time = now + time_tps()/STATS_PUBLISH_RATE;
+    this->publish_stats();
+}
+
 GRAS_FORCE_INLINE bool BlockActor::is_work_allowed(void)
 {
+    //message-only blocks have no stream buffers to wait on
+    if GRAS_UNLIKELY(data->message_only) return (
+        this->prio_token.unique() and
+        data->block_state == BLOCK_STATE_LIVE and
+        data->inputs_available.any() and
+        data->outputs_backpressure.none()
+    );
+
     return (
         this->prio_token.unique() and
         data->block_state == BLOCK_STATE_LIVE and
         data->inputs_available.any() and
         data->input_queues.all_ready() and
-        data->output_queues.all_ready()
+        data->output_queues.all_ready() and
+        data->outputs_backpressure.none()
     );
 }
 
@@ -8,16 +8,30 @@
 #include <gras_impl/bitset.hpp>
 #include <gras_impl/token.hpp>
 #include <gras_impl/stats.hpp>
+#include <gras_impl/stats_snapshot.hpp>
+#include <gras_impl/log_histogram.hpp>
 #include <gras_impl/output_buffer_queues.hpp>
 #include <gras_impl/input_buffer_queues.hpp>
-#include <gras_impl/interruptible_thread.hpp>
+#include <gras_impl/tag_store.hpp>
+#include <gras_impl/msg_queue.hpp>
+#include <gras_impl/msg_buffer_pool.hpp>
+#include <boost/thread/mutex.hpp>
 #include <vector>
+#include <deque>
 #include <set>
 #include <map>
 
 namespace gras
 {
 
+//! The production stamp of a buffer that is queued on an input port
+struct LatencyStamp
+{
+    time_ticks_t produce_time;
+    time_ticks_t origin_time;
+    size_t bytes; //bytes of the buffer that are not yet consumed
+};
+
 enum BlockState
 {
     BLOCK_STATE_INIT,
@@ -54,25 +68,60 @@ struct BlockData
     std::vector<time_ticks_t> time_output_not_ready;
 
     //tag and msg tracking
-    std::vector<bool> input_tags_changed;
-    std::vector<std::vector<Tag> > input_tags;
+    std::vector<TagStore> input_tags;
+    std::vector<std::vector<Tag> > output_tags;
     std::vector<size_t> num_input_msgs_read;
     std::vector<size_t> num_input_items_read;
     std::vector<size_t> num_output_items_read;
     std::vector<size_t> total_items_consumed;
     std::vector<size_t> total_items_produced;
-    std::vector<std::vector<PMCC> > input_msgs;
+    std::vector<MsgQueue> input_msgs;
+
+    //typed msg slot pools per output port
+    typedef std::pair<const std::type_info *, boost::shared_ptr<MsgSlotPool> > MsgSlotPoolEntry;
+    std::vector<std::vector<MsgSlotPoolEntry> > output_msg_pools;
+    boost::mutex output_msg_pools_mutex;
+
+    //msg payload buffer pools per output port
+    std::vector<boost::shared_ptr<MsgBufferPool> > output_msg_buffer_pools;
+
+    //msg port backpressure from full downstream queues
+    BitSet outputs_backpressure;
+    std::vector<std::vector<WeakToken> > output_msg_pressure;
 
-    //interruptible thread stuff
-    SharedThreadGroup thread_group;
-    boost::shared_ptr<InterruptibleThread> interruptible_thread;
+    //cooperative cancellation for blocking work
+    CancelToken cancel_token;
+
+    //lock-free params, latched before each work call
+    std::vector<std::pair<std::string, BlockParamsBase *> > params;
 
     //is the fg running?
     BlockState block_state;
 
+    //declared message-only: skip the stream machinery
+    bool message_only;
+
+    //hardware counters around work calls
+    bool perf_counters;
+
+    //latency tracking of stream buffers per input port
+    bool latency_tracking;
+    time_ticks_t work_origin_time;
+    std::vector<std::deque<LatencyStamp> > input_latency_stamps;
+    std::vector<LogHistogram> input_queue_latency;
+    std::vector<LogHistogram> input_source_latency;
+
+    //distributions of the work calls
+    LogHistogram work_time_histogram;
+    LogHistogram input_items_histogram;
+    LogHistogram output_items_histogram;
+
     std::vector<std::vector<OutputHintMessage> > output_allocation_hints;
+    std::vector<TagSubscription> output_tag_subscriptions;
 
     BlockStats stats;
+    StatsSnapshot stats_snapshot;
+    time_ticks_t stats_publish_time;
 };
 
 } //namespace gras
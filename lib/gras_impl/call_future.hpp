@@ -0,0 +1,54 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#ifndef INCLUDED_LIBGRAS_IMPL_CALL_FUTURE_HPP
+#define INCLUDED_LIBGRAS_IMPL_CALL_FUTURE_HPP
+
+#include <gras/call_future.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <string>
+
+namespace gras
+{
+
+/*!
+ * The shared state of a call future.
+ * The caller holds the future, and the call message holds the state,
+ * so the block can complete the call after the caller stopped waiting.
+ */
+struct CallFutureImpl
+{
+    CallFutureImpl(const std::string &name):
+        name(name),
+        done(false)
+    {}
+
+    //! Complete the call with a return value
+    void set_value(const PMCC &value)
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        ret = value;
+        done = true;
+        cond.notify_all();
+    }
+
+    //! Complete the call with an error message
+    void set_error(const std::string &message)
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        error = message;
+        done = true;
+        cond.notify_all();
+    }
+
+    const std::string name;
+    boost::mutex mutex;
+    boost::condition_variable cond;
+    bool done;
+    PMCC ret;
+    std::string error;
+};
+
+} //namespace gras
+
+#endif /*INCLUDED_LIBGRAS_IMPL_CALL_FUTURE_HPP*/
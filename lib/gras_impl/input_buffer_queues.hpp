@@ -156,6 +156,13 @@ struct InputBufferQueues
         ASSERT(total_idle_times[i] <= (time_now() - _init_time));
     }
 
+    //! The idle time of a port, including an idle interval that is still open
+    GRAS_FORCE_INLINE time_ticks_t idle_time(const size_t i, const time_ticks_t now) const
+    {
+        if (_bitset[i]) return total_idle_times[i];
+        return total_idle_times[i] + (now - _became_idle_times[i]);
+    }
+
     GRAS_FORCE_INLINE size_t get_items_enqueued(const size_t i)
     {
         return _enqueued_bytes[i]/_items_sizes[i];
@@ -0,0 +1,199 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#ifndef INCLUDED_LIBGRAS_IMPL_JSON_WRITER_HPP
+#define INCLUDED_LIBGRAS_IMPL_JSON_WRITER_HPP
+
+#include <boost/math/special_functions/fpclassify.hpp>
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace gras
+{
+
+/*!
+ * The json writer appends a json document straight into a string.
+ * The query results are written member by member as they are read,
+ * without building a property tree and then re-formatting it.
+ * Numbers are written as typed numbers, and commas between
+ * the members of an object or array are inserted automatically.
+ */
+struct JsonWriter
+{
+    JsonWriter(void):
+        _after_key(false)
+    {
+        _buff.reserve(4096);
+    }
+
+    //! The document written so far
+    const std::string &str(void) const
+    {
+        return _buff;
+    }
+
+    void begin_object(void)
+    {
+        this->separate();
+        _buff += '{';
+        _first.push_back(true);
+    }
+
+    void end_object(void)
+    {
+        _first.pop_back();
+        _buff += '}';
+    }
+
+    void begin_array(void)
+    {
+        this->separate();
+        _buff += '[';
+        _first.push_back(true);
+    }
+
+    void end_array(void)
+    {
+        _first.pop_back();
+        _buff += ']';
+    }
+
+    //! Write the key of the next object member
+    void key(const std::string &k)
+    {
+        this->separate();
+        this->write_string(k.data(), k.size());
+        _buff += ':';
+        _after_key = true;
+    }
+
+    void key(const char *k)
+    {
+        this->separate();
+        this->write_string(k, std::char_traits<char>::length(k));
+        _buff += ':';
+        _after_key = true;
+    }
+
+    void value(const std::string &s)
+    {
+        this->separate();
+        this->write_string(s.data(), s.size());
+    }
+
+    void value(const char *s)
+    {
+        this->separate();
+        this->write_string(s, std::char_traits<char>::length(s));
+    }
+
+    void value(const bool b)
+    {
+        this->separate();
+        _buff += b? "true" : "false";
+    }
+
+    void value(const int v){this->write_signed(v);}
+    void value(const long v){this->write_signed(v);}
+    void value(const long long v){this->write_signed(v);}
+    void value(const unsigned v){this->write_unsigned(v);}
+    void value(const unsigned long v){this->write_unsigned(v);}
+    void value(const unsigned long long v){this->write_unsigned(v);}
+
+    void value(const double v)
+    {
+        //json has no representation for nan and inf
+        if (not (boost::math::isfinite)(v)) return this->null_value();
+        this->separate();
+        char s[32];
+        std::sprintf(s, "%.*g", std::numeric_limits<double>::digits10 + 1, v);
+        _buff += s;
+    }
+
+    template <typename T>
+    void value(const std::vector<T> &v)
+    {
+        this->begin_array();
+        for (size_t i = 0; i < v.size(); i++) this->value(v[i]);
+        this->end_array();
+    }
+
+    void null_value(void)
+    {
+        this->separate();
+        _buff += "null";
+    }
+
+    //! Write an object member: the key and its value
+    template <typename T>
+    void field(const char *k, const T &v)
+    {
+        this->key(k);
+        this->value(v);
+    }
+
+private:
+    //a comma before every member but the first of its container
+    void separate(void)
+    {
+        if (_after_key)
+        {
+            _after_key = false;
+            return;
+        }
+        if (_first.empty()) return;
+        if (not _first.back()) _buff += ',';
+        _first.back() = false;
+    }
+
+    void write_signed(const long long v)
+    {
+        this->separate();
+        char s[32];
+        std::sprintf(s, "%lld", v);
+        _buff += s;
+    }
+
+    void write_unsigned(const unsigned long long v)
+    {
+        this->separate();
+        char s[32];
+        std::sprintf(s, "%llu", v);
+        _buff += s;
+    }
+
+    void write_string(const char *s, const size_t len)
+    {
+        _buff += '"';
+        for (size_t i = 0; i < len; i++)
+        {
+            const char ch = s[i];
+            switch (ch)
+            {
+            case '"': _buff += "\\\""; break;
+            case '\\': _buff += "\\\\"; break;
+            case '\n': _buff += "\\n"; break;
+            case '\r': _buff += "\\r"; break;
+            case '\t': _buff += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(ch) < 0x20)
+                {
+                    char esc[8];
+                    std::sprintf(esc, "\\u%04x", unsigned(ch));
+                    _buff += esc;
+                }
+                else _buff += ch;
+            }
+        }
+        _buff += '"';
+    }
+
+    std::string _buff;
+    std::vector<bool> _first;
+    bool _after_key;
+};
+
+} //namespace gras
+
+#endif /*INCLUDED_LIBGRAS_IMPL_JSON_WRITER_HPP*/
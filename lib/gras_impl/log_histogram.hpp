@@ -0,0 +1,97 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#ifndef INCLUDED_LIBGRAS_IMPL_LOG_HISTOGRAM_HPP
+#define INCLUDED_LIBGRAS_IMPL_LOG_HISTOGRAM_HPP
+
+#include <gras/chrono.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace gras
+{
+
+/*!
+ * A log-linear histogram of durations in time ticks, or of counts.
+ * Each power of two is split into 2^SUB_BITS linear buckets,
+ * so the relative error of any bucket is at most 1/2^SUB_BITS,
+ * with a fixed and small number of buckets for any range.
+ * Durations past the largest bucket fall into the largest bucket.
+ */
+struct LogHistogram
+{
+    enum
+    {
+        SUB_BITS = 3,
+        SUB_COUNT = 1 << SUB_BITS,
+        MAX_BITS = 48,
+        NUM_BUCKETS = (MAX_BITS - SUB_BITS + 1)*SUB_COUNT,
+    };
+
+    LogHistogram(void):
+        count(0),
+        max(0),
+        buckets(NUM_BUCKETS, 0)
+    {}
+
+    //! Get the bucket index for a value
+    static GRAS_FORCE_INLINE size_t bucket_index(const time_ticks_t t)
+    {
+        if GRAS_UNLIKELY(t <= 0) return 0;
+        const unsigned long long v = t;
+        if (v < SUB_COUNT) return size_t(v);
+        #ifdef __GNUC__
+        const size_t msb = 63 - __builtin_clzll(v);
+        #else
+        size_t msb = SUB_BITS;
+        while (msb < 63 and (v >> (msb+1)) != 0) msb++;
+        #endif
+        if GRAS_UNLIKELY(msb >= MAX_BITS) return NUM_BUCKETS-1;
+        const size_t sub = size_t(v >> (msb - SUB_BITS)) & (SUB_COUNT-1);
+        return (msb - SUB_BITS + 1)*SUB_COUNT + sub;
+    }
+
+    //! Get the smallest value that falls into a bucket
+    static GRAS_FORCE_INLINE time_ticks_t bucket_floor(const size_t index)
+    {
+        if (index < SUB_COUNT) return time_ticks_t(index);
+        const size_t msb = index/SUB_COUNT + SUB_BITS - 1;
+        const size_t sub = index % SUB_COUNT;
+        return time_ticks_t((SUB_COUNT + sub)) << (msb - SUB_BITS);
+    }
+
+    GRAS_FORCE_INLINE void record(const time_ticks_t t)
+    {
+        buckets[bucket_index(t)]++;
+        count++;
+        max = std::max(max, t);
+    }
+
+    //! Get the value below which the fraction p of samples fall
+    time_ticks_t percentile(const double p) const
+    {
+        if (count == 0) return 0;
+        const unsigned long long target = std::max<unsigned long long>(1, (unsigned long long)(p*count + 0.5));
+        unsigned long long total = 0;
+        for (size_t i = 0; i < buckets.size(); i++)
+        {
+            total += buckets[i];
+            if (total >= target) return std::min(max, bucket_floor(i+1));
+        }
+        return max;
+    }
+
+    void clear(void)
+    {
+        count = 0;
+        max = 0;
+        std::fill(buckets.begin(), buckets.end(), 0);
+    }
+
+    unsigned long long count;
+    time_ticks_t max;
+    std::vector<unsigned long long> buckets;
+};
+
+} //namespace gras
+
+#endif /*INCLUDED_LIBGRAS_IMPL_LOG_HISTOGRAM_HPP*/
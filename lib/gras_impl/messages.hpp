@@ -8,9 +8,12 @@
 #include <gras/tags.hpp>
 #include <gras/sbuffer.hpp>
 #include <gras_impl/token.hpp>
-#include <gras_impl/stats.hpp>
 #include <gras/block_config.hpp>
-#include <gras_impl/interruptible_thread.hpp>
+#include <gras/cancel_token.hpp>
+#include <gras/callable.hpp>
+#include <gras_impl/call_future.hpp>
+#include <gras_impl/tag_subscription.hpp>
+#include <vector>
 
 namespace gras
 {
@@ -47,9 +50,9 @@ struct TopConfigMessage
     Token prio_token;
 };
 
-struct TopThreadMessage
+struct TopCancelMessage
 {
-    SharedThreadGroup thread_group;
+    CancelToken cancel_token;
     Token prio_token;
 };
 
@@ -60,22 +63,29 @@ struct TopThreadMessage
 
 struct InputTagMessage
 {
-    InputTagMessage(const Tag &tag):tag(tag){}
     size_t index;
-    Tag tag;
+    std::vector<Tag> tags; //sorted by offset
 };
 
 struct InputMsgMessage
 {
-    InputMsgMessage(const PMCC &msg):msg(msg){}
+    InputMsgMessage(const PMCC &msg, const MsgSlotPtr &slot = MsgSlotPtr()):msg(msg), slot(slot){}
     size_t index;
     PMCC msg;
+    MsgSlotPtr slot; //typed message, msg is null
 };
 
 struct InputBufferMessage
 {
+    InputBufferMessage(void):
+        produce_time(0),
+        origin_time(0)
+    {}
     size_t index;
     SBuffer buffer;
+    std::vector<Tag> tags; //sorted by offset
+    time_ticks_t produce_time; //stamped when latency tracking
+    time_ticks_t origin_time;
 };
 
 struct InputTokenMessage
@@ -127,6 +137,14 @@ struct OutputHintMessage
 {
     size_t index;
     size_t reserve_bytes;
+    TagSubscription tag_subscription;
+    WeakToken token;
+};
+
+struct OutputPressureMessage
+{
+    size_t index;
+    bool full;
     WeakToken token;
 };
 
@@ -148,11 +166,23 @@ struct OutputUpdateMessage
 
 struct CallableMessage
 {
+    CallableMessage(void):
+        entry(NULL), typed_args(NULL), typed_ret(NULL)
+    {}
     Token prio_token;
     std::string key;
     PMCC args;
     PMCC ret;
     std::string error;
+
+    //typed call from a call handle, the caller waits on the reply,
+    //so the arguments and return storage outlive the message
+    CallableRegistryEntry *entry;
+    const void *const *typed_args;
+    void *typed_ret;
+
+    //async call, the block completes the future instead of replying
+    boost::shared_ptr<CallFutureImpl> future;
 };
 
 struct SelfKickMessage
@@ -160,14 +190,6 @@ struct SelfKickMessage
     //empty
 };
 
-struct GetStatsMessage
-{
-    Token prio_token;
-    std::string block_id;
-    BlockStats stats;
-    time_ticks_t stats_time;
-};
-
 } //namespace gras
 
 #include <Theron/Register.h>
@@ -177,7 +199,7 @@ THERON_DECLARE_REGISTERED_MESSAGE(gras::TopActiveMessage);
 THERON_DECLARE_REGISTERED_MESSAGE(gras::TopInertMessage);
 THERON_DECLARE_REGISTERED_MESSAGE(gras::TopTokenMessage);
 THERON_DECLARE_REGISTERED_MESSAGE(gras::TopConfigMessage);
-THERON_DECLARE_REGISTERED_MESSAGE(gras::TopThreadMessage);
+THERON_DECLARE_REGISTERED_MESSAGE(gras::TopCancelMessage);
 
 THERON_DECLARE_REGISTERED_MESSAGE(gras::InputTagMessage);
 THERON_DECLARE_REGISTERED_MESSAGE(gras::InputMsgMessage);
@@ -191,11 +213,11 @@ THERON_DECLARE_REGISTERED_MESSAGE(gras::OutputBufferMessage);
 THERON_DECLARE_REGISTERED_MESSAGE(gras::OutputTokenMessage);
 THERON_DECLARE_REGISTERED_MESSAGE(gras::OutputCheckMessage);
 THERON_DECLARE_REGISTERED_MESSAGE(gras::OutputHintMessage);
+THERON_DECLARE_REGISTERED_MESSAGE(gras::OutputPressureMessage);
 THERON_DECLARE_REGISTERED_MESSAGE(gras::OutputAllocMessage);
 THERON_DECLARE_REGISTERED_MESSAGE(gras::OutputUpdateMessage);
 
 THERON_DECLARE_REGISTERED_MESSAGE(gras::CallableMessage);
 THERON_DECLARE_REGISTERED_MESSAGE(gras::SelfKickMessage);
-THERON_DECLARE_REGISTERED_MESSAGE(gras::GetStatsMessage);
 
 #endif /*INCLUDED_LIBGRAS_IMPL_MESSAGES_HPP*/
@@ -0,0 +1,117 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#ifndef INCLUDED_LIBGRAS_IMPL_MSG_BUFFER_POOL_HPP
+#define INCLUDED_LIBGRAS_IMPL_MSG_BUFFER_POOL_HPP
+
+#include <gras/sbuffer.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/bind.hpp>
+#include <vector>
+
+namespace gras
+{
+
+/*!
+ * The msg buffer pool recycles payload buffers for messages.
+ * Buffers are binned into power of two size classes.
+ * The pool token returns a buffer to its bin once the last
+ * reference is gone, which can happen in any thread.
+ * Oversized requests and full bins fall back to the heap.
+ */
+struct MsgBufferPool
+{
+    enum
+    {
+        MIN_CLASS_SHIFT = 6, //64 bytes
+        NUM_CLASSES = 15, //up to 1 MiB
+        MAX_PER_CLASS = 32,
+    };
+
+    //! The bins live apart from the pool, the token keeps them alive
+    struct Bins
+    {
+        boost::mutex mutex;
+        std::vector<SBuffer> bins[NUM_CLASSES];
+    };
+
+    MsgBufferPool(const long affinity):
+        affinity(affinity),
+        bins(new Bins())
+    {
+        token = SBufferToken(new SBufferDeleter(boost::bind(&MsgBufferPool::returner, bins, _1)));
+    }
+
+    ~MsgBufferPool(void)
+    {
+        //buffers outstanding will be freed normally
+        token.reset();
+    }
+
+    static GRAS_FORCE_INLINE size_t size_class(const size_t num_bytes)
+    {
+        size_t c = 0;
+        while ((size_t(1) << (c + MIN_CLASS_SHIFT)) < num_bytes) c++;
+        return c;
+    }
+
+    //! Get a buffer with at least num bytes, return true on a pool hit
+    GRAS_FORCE_INLINE bool get(const size_t num_bytes, SBuffer &buff)
+    {
+        const size_t c = size_class(num_bytes);
+        bool hit = false;
+        if GRAS_LIKELY(c < NUM_CLASSES)
+        {
+            boost::mutex::scoped_lock l(bins->mutex);
+            std::vector<SBuffer> &bin = bins->bins[c];
+            if GRAS_LIKELY(not bin.empty())
+            {
+                buff = bin.back();
+                bin.pop_back();
+                hit = true;
+            }
+        }
+
+        if GRAS_UNLIKELY(not hit)
+        {
+            SBufferConfig config;
+            config.length = (c < NUM_CLASSES)? (size_t(1) << (c + MIN_CLASS_SHIFT)) : num_bytes;
+            config.affinity = affinity;
+            if (c < NUM_CLASSES) config.token = token;
+            buff = SBuffer(config);
+        }
+
+        buff.offset = 0;
+        buff.length = num_bytes;
+        return hit;
+    }
+
+    static void returner(boost::shared_ptr<Bins> bins, SBuffer &buff)
+    {
+        buff.offset = 0;
+        buff.length = 0;
+        buff.last = NULL;
+
+        const size_t c = size_class(buff.get_actual_length());
+        {
+            boost::mutex::scoped_lock l(bins->mutex);
+            std::vector<SBuffer> &bin = bins->bins[c];
+            if GRAS_LIKELY(bin.size() < MAX_PER_CLASS)
+            {
+                bin.push_back(buff);
+                return;
+            }
+        }
+
+        //the bin is full, let this buffer be freed
+        buff->config.token.reset();
+    }
+
+    long affinity;
+    boost::shared_ptr<Bins> bins;
+    SBufferToken token;
+};
+
+} //namespace gras
+
+#endif /*INCLUDED_LIBGRAS_IMPL_MSG_BUFFER_POOL_HPP*/
@@ -0,0 +1,110 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#ifndef INCLUDED_LIBGRAS_IMPL_MSG_QUEUE_HPP
+#define INCLUDED_LIBGRAS_IMPL_MSG_QUEUE_HPP
+
+#include <gras/gras.hpp>
+#include <gras/detail/msg_slot.hpp>
+#include <PMC/PMC.hpp>
+#include <boost/circular_buffer.hpp>
+#include <algorithm>
+
+namespace gras
+{
+
+/*!
+ * An entry in the msg queue: either a PMC or a typed slot.
+ */
+struct MsgEntry
+{
+    MsgEntry(void){}
+    MsgEntry(const PMCC &msg, const MsgSlotPtr &slot):
+        msg(msg), slot(slot)
+    {}
+    PMCC msg;
+    MsgSlotPtr slot;
+};
+
+/*!
+ * The msg queue holds the async messages for a single input port.
+ * Messages are kept in a ring buffer so that the messages
+ * read during work are trimmed from the front without a shift.
+ *
+ * The depth is a soft bound: once the queue holds depth messages,
+ * the port is full and the upstream is told to stop producing.
+ * Messages already in flight are still accepted by growing the ring.
+ */
+struct MsgQueue
+{
+    enum {MIN_CAPACITY=16};
+
+    MsgQueue(void):
+        depth(0),
+        high_water(0),
+        backpressure(false),
+        _msgs(MIN_CAPACITY)
+    {}
+
+    //! Set the depth, 0 means unbounded
+    void set_depth(const size_t num)
+    {
+        depth = num;
+        this->reserve(depth);
+    }
+
+    GRAS_FORCE_INLINE void push(const MsgEntry &msg)
+    {
+        if GRAS_UNLIKELY(_msgs.full()) this->reserve(_msgs.size()+1);
+        _msgs.push_back(msg);
+        high_water = std::max(high_water, _msgs.size());
+    }
+
+    GRAS_FORCE_INLINE const MsgEntry &operator[](const size_t i) const
+    {
+        return _msgs[i];
+    }
+
+    //! Remove the first num messages from the queue
+    GRAS_FORCE_INLINE void pop_front(const size_t num)
+    {
+        _msgs.erase_begin(num);
+    }
+
+    //! Is the queue at or over its depth?
+    GRAS_FORCE_INLINE bool full(void) const
+    {
+        return depth != 0 and _msgs.size() >= depth;
+    }
+
+    GRAS_FORCE_INLINE size_t size(void) const
+    {
+        return _msgs.size();
+    }
+
+    GRAS_FORCE_INLINE bool empty(void) const
+    {
+        return _msgs.empty();
+    }
+
+    GRAS_FORCE_INLINE void clear(void)
+    {
+        _msgs.clear();
+    }
+
+    void reserve(const size_t num)
+    {
+        if (_msgs.capacity() >= num) return;
+        size_t capacity = std::max<size_t>(_msgs.capacity(), MIN_CAPACITY);
+        while (capacity < num) capacity *= 2;
+        _msgs.set_capacity(capacity);
+    }
+
+    size_t depth;
+    size_t high_water;
+    bool backpressure; //upstream was told that this port is full
+    boost::circular_buffer<MsgEntry> _msgs;
+};
+
+} //namespace gras
+
+#endif /*INCLUDED_LIBGRAS_IMPL_MSG_QUEUE_HPP*/
@@ -0,0 +1,58 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#ifndef INCLUDED_LIBGRAS_IMPL_PERF_COUNTERS_HPP
+#define INCLUDED_LIBGRAS_IMPL_PERF_COUNTERS_HPP
+
+#include <gras/gras.hpp>
+#include <gras_impl/stats.hpp>
+
+namespace gras
+{
+
+//! A reading of the hardware counters of the calling thread
+struct PerfCounterValues
+{
+    item_index_t cycles;
+    item_index_t instructions;
+    item_index_t cache_misses; //last level cache
+    item_index_t branch_misses;
+};
+
+/*!
+ * Read the hardware counters of the calling thread.
+ * The counters are opened the first time that a thread reads them.
+ * \return false when the counters are not available on this thread
+ */
+bool perf_counters_read(PerfCounterValues &values);
+
+/*!
+ * Accumulate the hardware counters over a scope into the block stats.
+ * The counters count the calling thread on any CPU,
+ * so the deltas around a work call belong to that block.
+ */
+struct PerfCounterAccumulate
+{
+    GRAS_FORCE_INLINE PerfCounterAccumulate(BlockStats &stats, const bool enabled):
+        stats(stats),
+        active(enabled and perf_counters_read(start))
+    {}
+
+    GRAS_FORCE_INLINE ~PerfCounterAccumulate(void)
+    {
+        if GRAS_LIKELY(not active) return;
+        PerfCounterValues stop;
+        if (not perf_counters_read(stop)) return;
+        stats.perf_cycles += stop.cycles - start.cycles;
+        stats.perf_instructions += stop.instructions - start.instructions;
+        stats.perf_cache_misses += stop.cache_misses - start.cache_misses;
+        stats.perf_branch_misses += stop.branch_misses - start.branch_misses;
+    }
+
+    BlockStats &stats;
+    PerfCounterValues start;
+    const bool active;
+};
+
+} //namespace gras
+
+#endif /*INCLUDED_LIBGRAS_IMPL_PERF_COUNTERS_HPP*/
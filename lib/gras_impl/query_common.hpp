@@ -3,6 +3,7 @@
 #ifndef INCLUDED_LIBGRAS_IMPL_QUERY_COMMON_HPP
 #define INCLUDED_LIBGRAS_IMPL_QUERY_COMMON_HPP
 
+#include <gras_impl/json_writer.hpp>
 #include <PMC/PMC.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <vector>
@@ -12,10 +13,9 @@
 namespace gras
 {
     PMCC ptree_to_pmc(const boost::property_tree::ptree &value);
-    boost::property_tree::ptree pmc_to_ptree(const PMCC &value);
+    void pmc_to_json(JsonWriter &json, const PMCC &value);
 
     boost::property_tree::ptree json_to_ptree(const std::string &s);
-    std::string ptree_to_json(const boost::property_tree::ptree &p);
 }
 
 #endif /*INCLUDED_LIBGRAS_IMPL_QUERY_COMMON_HPP*/
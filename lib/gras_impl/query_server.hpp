@@ -0,0 +1,81 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#ifndef INCLUDED_LIBGRAS_IMPL_QUERY_SERVER_HPP
+#define INCLUDED_LIBGRAS_IMPL_QUERY_SERVER_HPP
+
+#include <gras/top_block.hpp>
+#include <boost/asio.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace gras
+{
+
+/*!
+ * The query server is a small http server for the query interface.
+ * It serves the query web assets, answers the json query paths,
+ * and streams stats deltas to a client as server sent events.
+ *
+ * Connections are accepted and their requests are read asynchronously
+ * on one io thread, and a client that does not send its request
+ * in time is closed, so idle clients do not hold any threads.
+ * Each request is then handled in its own thread with blocking io,
+ * so that a slow client or a long lived event stream
+ * never holds up the other clients, up to a limit of connections.
+ * The destructor closes all connections and waits for their threads.
+ */
+struct QueryServer
+{
+    enum {MAX_CONNECTIONS = 32}; //handled at once, more are turned away
+    enum {REQUEST_TIMEOUT_MS = 10000}; //to receive the request head
+
+    QueryServer(ElementImpl *self, const unsigned short port, const std::string &assets_dir, const std::string &bind_address);
+
+    ~QueryServer(void);
+
+    //! The tcp port that the server listens on
+    unsigned short port(void) const;
+
+private:
+    struct Connection;
+    struct ConnectionCount;
+    typedef boost::shared_ptr<Connection> ConnectionSptr;
+    typedef boost::shared_ptr<boost::asio::ip::tcp::acceptor> AcceptorSptr;
+
+    void bind_acceptors(const std::string &bind_address, const unsigned short port);
+    void accept_loop(AcceptorSptr acceptor);
+    void handle_accept(AcceptorSptr acceptor, ConnectionSptr conn, const boost::system::error_code &ec);
+    void handle_timeout(ConnectionSptr conn, const boost::system::error_code &ec);
+    void handle_read(ConnectionSptr conn, const boost::system::error_code &ec);
+    void handle_shutdown(void);
+    void handle_connection(ConnectionSptr conn);
+    void handle_request(boost::asio::ip::tcp::socket &socket, const std::string &path, const std::string &query_string);
+    void handle_events(boost::asio::ip::tcp::socket &socket, const std::string &query_string);
+    bool sleep_while_running(const double seconds);
+
+    //a handle to the top block that does not own it,
+    //the server is destroyed before the top block is
+    TopBlock _top_block;
+    const std::string _assets_dir;
+
+    //the io service outlives the sockets of all connections
+    boost::asio::io_service _io_service;
+    std::vector<AcceptorSptr> _acceptors;
+    std::set<Connection *> _pending; //reading requests, only used on the io thread
+    boost::thread _io_thread;
+
+    boost::mutex _mutex;
+    boost::condition_variable _cond;
+    bool _running;
+    size_t _num_connections;
+    std::set<boost::asio::ip::tcp::socket *> _sockets; //handled in threads
+};
+
+} //namespace gras
+
+#endif /*INCLUDED_LIBGRAS_IMPL_QUERY_SERVER_HPP*/
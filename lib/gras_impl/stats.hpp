@@ -23,6 +23,24 @@ struct BlockStats
         total_time_post = 0;
         total_time_input = 0;
         total_time_output = 0;
+        actor_queue_depth = 0;
+        work_time_p50 = 0;
+        work_time_p90 = 0;
+        work_time_p99 = 0;
+        work_time_max = 0;
+        input_items_p50 = 0;
+        input_items_p90 = 0;
+        input_items_p99 = 0;
+        input_items_max = 0;
+        output_items_p50 = 0;
+        output_items_p90 = 0;
+        output_items_p99 = 0;
+        output_items_max = 0;
+        perf_cycles = 0;
+        perf_instructions = 0;
+        perf_cache_misses = 0;
+        perf_branch_misses = 0;
+        perf_enabled = 0;
     }
 
     time_ticks_t init_time;
@@ -35,7 +53,10 @@ struct BlockStats
     std::vector<item_index_t> msgs_consumed;
     std::vector<item_index_t> items_produced;
     std::vector<item_index_t> tags_produced;
+    std::vector<item_index_t> tags_dropped;
     std::vector<item_index_t> msgs_produced;
+    std::vector<item_index_t> msg_buffers_hit;
+    std::vector<item_index_t> msg_buffers_miss;
     std::vector<item_index_t> bytes_copied;
 
     //port starvation tracking
@@ -46,8 +67,20 @@ struct BlockStats
     size_t actor_queue_depth;
     std::vector<size_t> items_enqueued;
     std::vector<size_t> msgs_enqueued;
+    std::vector<size_t> msgs_high_water;
     std::vector<size_t> tags_enqueued;
 
+    //input latency percentiles when tracking
+    std::vector<item_index_t> latency_samples;
+    std::vector<time_ticks_t> queue_latency_p50;
+    std::vector<time_ticks_t> queue_latency_p90;
+    std::vector<time_ticks_t> queue_latency_p99;
+    std::vector<time_ticks_t> queue_latency_max;
+    std::vector<time_ticks_t> source_latency_p50;
+    std::vector<time_ticks_t> source_latency_p90;
+    std::vector<time_ticks_t> source_latency_p99;
+    std::vector<time_ticks_t> source_latency_max;
+
     item_index_t work_count;
     time_ticks_t time_last_work;
     time_ticks_t total_time_prep;
@@ -55,8 +88,51 @@ struct BlockStats
     time_ticks_t total_time_post;
     time_ticks_t total_time_input;
     time_ticks_t total_time_output;
+
+    //distributions of the work calls
+    time_ticks_t work_time_p50;
+    time_ticks_t work_time_p90;
+    time_ticks_t work_time_p99;
+    time_ticks_t work_time_max;
+    item_index_t input_items_p50;
+    item_index_t input_items_p90;
+    item_index_t input_items_p99;
+    item_index_t input_items_max;
+    item_index_t output_items_p50;
+    item_index_t output_items_p90;
+    item_index_t output_items_p99;
+    item_index_t output_items_max;
+
+    //hardware counters accumulated over work calls
+    item_index_t perf_cycles;
+    item_index_t perf_instructions;
+    item_index_t perf_cache_misses;
+    item_index_t perf_branch_misses;
+    item_index_t perf_enabled; //1 when the block was configured to count
 };
 
+//! The scalar members of BlockStats, used to flatten the stats
+#define GRAS_BLOCK_STATS_SCALARS(X) \
+    X(init_time) X(start_time) X(stop_time) X(actor_queue_depth) \
+    X(work_count) X(time_last_work) X(total_time_prep) X(total_time_work) \
+    X(total_time_post) X(total_time_input) X(total_time_output) \
+    X(work_time_p50) X(work_time_p90) X(work_time_p99) X(work_time_max) \
+    X(input_items_p50) X(input_items_p90) X(input_items_p99) X(input_items_max) \
+    X(output_items_p50) X(output_items_p90) X(output_items_p99) X(output_items_max) \
+    X(perf_cycles) X(perf_instructions) X(perf_cache_misses) X(perf_branch_misses) \
+    X(perf_enabled)
+
+//! The per port members of BlockStats, used to flatten the stats
+#define GRAS_BLOCK_STATS_VECTORS(X) \
+    X(items_consumed) X(tags_consumed) X(msgs_consumed) \
+    X(items_produced) X(tags_produced) X(tags_dropped) X(msgs_produced) \
+    X(msg_buffers_hit) X(msg_buffers_miss) X(bytes_copied) \
+    X(inputs_idle) X(outputs_idle) \
+    X(items_enqueued) X(msgs_enqueued) X(msgs_high_water) X(tags_enqueued) \
+    X(latency_samples) X(queue_latency_p50) X(queue_latency_p90) \
+    X(queue_latency_p99) X(queue_latency_max) X(source_latency_p50) \
+    X(source_latency_p90) X(source_latency_p99) X(source_latency_max)
+
 } //namespace gras
 
 #endif /*INCLUDED_LIBGRAS_IMPL_STATS_HPP*/
@@ -0,0 +1,150 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#ifndef INCLUDED_LIBGRAS_IMPL_STATS_SNAPSHOT_HPP
+#define INCLUDED_LIBGRAS_IMPL_STATS_SNAPSHOT_HPP
+
+#include <gras_impl/stats.hpp>
+#include <boost/thread/thread.hpp>
+#include <algorithm>
+#include <vector>
+
+#ifdef BOOST_MSVC
+#include <intrin.h>
+#endif
+
+namespace gras
+{
+
+GRAS_FORCE_INLINE void stats_memory_barrier(void)
+{
+    #ifdef BOOST_MSVC
+    _mm_mfence();
+    #else
+    __sync_synchronize();
+    #endif
+}
+
+/*!
+ * The stats snapshot is a seqlock protected copy of the block stats.
+ * The block's actor publishes its stats every so often,
+ * and any thread can read the last published stats
+ * without sending a message or waiting on a busy block.
+ *
+ * The stats are flattened into an area of words;
+ * the sequence count is odd while the area is written,
+ * and readers retry until they copy the area between
+ * two equal and even reads of the sequence count.
+ * An area that is outgrown is retired, but never freed
+ * while the snapshot lives, since a reader may be copying it.
+ *
+ * Each area starts with a header of its capacity and length,
+ * and readers only use the header of the area that they copy,
+ * so a reader that races a growing publish never reads past its area.
+ */
+struct StatsSnapshot
+{
+    enum {HEADER_WORDS = 2}; //capacity and length
+
+    StatsSnapshot(void):
+        _seq(0),
+        _words(NULL),
+        _capacity(0)
+    {}
+
+    ~StatsSnapshot(void)
+    {
+        for (size_t i = 0; i < _retired.size(); i++) delete [] _retired[i];
+        delete [] _words;
+    }
+
+    //! Publish the stats, only called from the actor
+    void publish(const BlockStats &stats, const time_ticks_t stats_time)
+    {
+        //flatten outside of the write section to keep it short
+        _scratch.clear();
+        _scratch.push_back(item_index_t(stats_time));
+        #define my_flatten_scalar(l) _scratch.push_back(item_index_t(stats.l));
+        #define my_flatten_vector(l) { \
+            _scratch.push_back(stats.l.size()); \
+            for (size_t i = 0; i < stats.l.size(); i++) \
+                _scratch.push_back(item_index_t(stats.l[i])); \
+        }
+        GRAS_BLOCK_STATS_SCALARS(my_flatten_scalar)
+        GRAS_BLOCK_STATS_VECTORS(my_flatten_vector)
+        #undef my_flatten_scalar
+        #undef my_flatten_vector
+
+        //grow into a new area, readers may still hold the old one
+        volatile item_index_t *words = _words;
+        if GRAS_UNLIKELY(_scratch.size() > _capacity)
+        {
+            _capacity = _scratch.size()*2;
+            if (words != NULL) _retired.push_back(words);
+            words = new item_index_t[HEADER_WORDS + _capacity];
+            words[0] = _capacity; //never changes for this area
+            words[1] = 0;
+        }
+
+        _seq = _seq + 1;
+        stats_memory_barrier();
+        for (size_t i = 0; i < _scratch.size(); i++) words[HEADER_WORDS + i] = _scratch[i];
+        words[1] = _scratch.size();
+        _words = words;
+        stats_memory_barrier();
+        _seq = _seq + 1;
+    }
+
+    //! Read the last published stats, called from any thread
+    bool read(BlockStats &stats, time_ticks_t &stats_time) const
+    {
+        std::vector<item_index_t> words;
+        while (true)
+        {
+            const size_t seq = _seq;
+            stats_memory_barrier();
+            if GRAS_UNLIKELY(seq & 1)
+            {
+                boost::this_thread::yield();
+                continue;
+            }
+            //the length may be torn, but never exceeds this area's capacity
+            const volatile item_index_t *area = _words;
+            const size_t num_words = (area == NULL)? 0 : std::min(size_t(area[1]), size_t(area[0]));
+            words.resize(num_words);
+            for (size_t i = 0; i < num_words; i++) words[i] = area[HEADER_WORDS + i];
+            stats_memory_barrier();
+            if GRAS_LIKELY(_seq == seq) break;
+        }
+        if (words.empty()) return false;
+
+        //unflatten in the same order as publish
+        size_t j = 0;
+        stats_time = time_ticks_t(words[j++]);
+        #define my_unflatten_scalar(l) stats.l = words[j++];
+        #define my_unflatten_vector(l) { \
+            stats.l.resize(size_t(words[j++])); \
+            for (size_t i = 0; i < stats.l.size(); i++) \
+                stats.l[i] = words[j++]; \
+        }
+        GRAS_BLOCK_STATS_SCALARS(my_unflatten_scalar)
+        GRAS_BLOCK_STATS_VECTORS(my_unflatten_vector)
+        #undef my_unflatten_scalar
+        #undef my_unflatten_vector
+        return true;
+    }
+
+    //the sequence count sits on its own cache line
+    char _pad0[GRAS_MAX_ALIGNMENT];
+    volatile size_t _seq;
+    volatile item_index_t * volatile _words;
+    char _pad1[GRAS_MAX_ALIGNMENT];
+
+    //only touched by the publishing actor
+    size_t _capacity;
+    std::vector<item_index_t> _scratch;
+    std::vector<volatile item_index_t *> _retired;
+};
+
+} //namespace gras
+
+#endif /*INCLUDED_LIBGRAS_IMPL_STATS_SNAPSHOT_HPP*/
@@ -0,0 +1,135 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#ifndef INCLUDED_LIBGRAS_IMPL_TAG_STORE_HPP
+#define INCLUDED_LIBGRAS_IMPL_TAG_STORE_HPP
+
+#include <gras/tags.hpp>
+#include <gras/tag_iter.hpp>
+#include <boost/circular_buffer.hpp>
+#include <algorithm>
+#include <iterator>
+
+namespace gras
+{
+
+//! Compare tags to absolute offsets for binary searches
+struct TagOffsetLess
+{
+    GRAS_FORCE_INLINE bool operator()(const Tag &lhs, const item_index_t rhs) const
+    {
+        return lhs.offset < rhs;
+    }
+
+    GRAS_FORCE_INLINE bool operator()(const item_index_t lhs, const Tag &rhs) const
+    {
+        return lhs < rhs.offset;
+    }
+};
+
+/*!
+ * The tag store holds the tags for a single input port.
+ * Tags are kept in a ring buffer, always sorted by offset:
+ *  - Tags typically arrive in order, which is an append.
+ *  - Out of order tags fall back to an insert or a merge.
+ *  - Consumed tags are trimmed from the front without a shift.
+ *  - Offset range lookups are binary searches.
+ */
+struct TagStore
+{
+    enum {MIN_CAPACITY=16};
+
+    typedef boost::circular_buffer<Tag>::const_iterator const_iterator;
+
+    TagStore(void):
+        _tags(MIN_CAPACITY)
+    {}
+
+    //! Insert a single tag in order of offset
+    GRAS_FORCE_INLINE void push(const Tag &tag)
+    {
+        this->reserve(1);
+
+        //common case: the new tag goes in the back
+        if GRAS_LIKELY(_tags.empty() or not (tag < _tags.back()))
+        {
+            _tags.push_back(tag);
+            return;
+        }
+
+        //out of order: insert after tags with an equal offset
+        _tags.insert(std::upper_bound(_tags.begin(), _tags.end(), tag), tag);
+    }
+
+    //! Insert a range of tags, which are sorted by offset
+    template <typename Iter>
+    void push(Iter first, Iter last)
+    {
+        if (first == last) return;
+        this->reserve(std::distance(first, last));
+
+        //common case: the new tags go in the back
+        const size_t old_size = _tags.size();
+        const bool in_order = _tags.empty() or not (*first < _tags.back());
+        _tags.insert(_tags.end(), first, last);
+        if GRAS_LIKELY(in_order) return;
+
+        //out of order: merge the two sorted runs
+        std::inplace_merge(_tags.begin(), _tags.begin()+old_size, _tags.end());
+    }
+
+    //! Get all tags in the store
+    GRAS_FORCE_INLINE TagIter all(void) const
+    {
+        return TagIter(_tags.begin(), _tags.end());
+    }
+
+    //! Get tags with absolute offsets in the range [begin, end)
+    GRAS_FORCE_INLINE TagIter range(const item_index_t begin, const item_index_t end) const
+    {
+        const const_iterator first = std::lower_bound(_tags.begin(), _tags.end(), begin, TagOffsetLess());
+        const const_iterator last = std::lower_bound(first, _tags.end(), end, TagOffsetLess());
+        return TagIter(first, last);
+    }
+
+    //! Get the number of tags with an offset before the given offset
+    GRAS_FORCE_INLINE size_t count_before(const item_index_t offset) const
+    {
+        if GRAS_LIKELY(_tags.empty() or _tags.front().offset >= offset) return 0;
+        return std::lower_bound(_tags.begin(), _tags.end(), offset, TagOffsetLess()) - _tags.begin();
+    }
+
+    //! Remove the first num tags from the store
+    GRAS_FORCE_INLINE void pop_front(const size_t num)
+    {
+        _tags.erase_begin(num);
+    }
+
+    GRAS_FORCE_INLINE size_t size(void) const
+    {
+        return _tags.size();
+    }
+
+    GRAS_FORCE_INLINE bool empty(void) const
+    {
+        return _tags.empty();
+    }
+
+    GRAS_FORCE_INLINE void clear(void)
+    {
+        _tags.clear();
+    }
+
+    GRAS_FORCE_INLINE void reserve(const size_t num)
+    {
+        if GRAS_LIKELY(_tags.reserve() >= num) return;
+        size_t capacity = _tags.capacity()*2;
+        while (capacity < _tags.size() + num) capacity *= 2;
+        _tags.set_capacity(capacity);
+    }
+
+    boost::circular_buffer<Tag> _tags;
+};
+
+} //namespace gras
+
+#endif /*INCLUDED_LIBGRAS_IMPL_TAG_STORE_HPP*/
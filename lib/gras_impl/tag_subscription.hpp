@@ -0,0 +1,98 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#ifndef INCLUDED_LIBGRAS_IMPL_TAG_SUBSCRIPTION_HPP
+#define INCLUDED_LIBGRAS_IMPL_TAG_SUBSCRIPTION_HPP
+
+#include <gras/tags.hpp>
+#include <gras/block_config.hpp>
+#include <boost/foreach.hpp>
+#include <vector>
+
+namespace gras
+{
+
+/*!
+ * A tag subscription is the set of tags wanted on a stream.
+ * Subscriptions are passed upstream with the allocation hints,
+ * and merged by each block so that the producer can drop
+ * tags that no reachable downstream block will ever read.
+ */
+struct TagSubscription
+{
+    //! Subscribe to all tags (the conservative default)
+    TagSubscription(void):
+        all(true)
+    {}
+
+    //! Make a subscription from the declared input port config
+    TagSubscription(const InputPortConfig &config):
+        all(config.consume_all_tags),
+        keys(config.consumed_tag_keys)
+    {}
+
+    //! Does the subscription want this tag?
+    GRAS_FORCE_INLINE bool wants(const Tag &tag) const
+    {
+        if GRAS_LIKELY(all) return true;
+        if (keys.empty()) return false;
+        //tags without a key can not be filtered
+        if (not tag.object.is<StreamTag>()) return true;
+        return this->wants_key(tag.object.as<StreamTag>().get_key_id());
+    }
+
+    //! Is this key in the set of subscribed keys?
+    GRAS_FORCE_INLINE bool wants_key(const TagKey &key) const
+    {
+        if (all) return true;
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            if (keys[i] == key) return true;
+        }
+        return false;
+    }
+
+    //! Is this subscription the empty set?
+    bool none(void) const
+    {
+        return not all and keys.empty();
+    }
+
+    //! Union with another subscription
+    void merge(const TagSubscription &other)
+    {
+        if (all) return;
+        if (other.all)
+        {
+            all = true;
+            keys.clear();
+            return;
+        }
+        BOOST_FOREACH(const TagKey &k, other.keys)
+        {
+            if (not this->wants_key(k)) keys.push_back(k);
+        }
+    }
+
+    bool operator==(const TagSubscription &other) const
+    {
+        if (all or other.all) return all == other.all;
+        if (keys.size() != other.keys.size()) return false;
+        BOOST_FOREACH(const TagKey &k, keys)
+        {
+            if (not other.wants_key(k)) return false;
+        }
+        return true;
+    }
+
+    bool operator!=(const TagSubscription &other) const
+    {
+        return not (*this == other);
+    }
+
+    bool all;
+    std::vector<TagKey> keys;
+};
+
+} //namespace gras
+
+#endif /*INCLUDED_LIBGRAS_IMPL_TAG_SUBSCRIPTION_HPP*/
@@ -0,0 +1,78 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#ifndef INCLUDED_LIBGRAS_IMPL_TRACE_HPP
+#define INCLUDED_LIBGRAS_IMPL_TRACE_HPP
+
+#include <gras/chrono.hpp>
+#include <vector>
+
+namespace gras
+{
+
+/*!
+ * A scheduler event recorded while a trace is captured.
+ * The name is a string literal and the source is the actor,
+ * so that recording an event never allocates or copies.
+ */
+struct TraceEvent
+{
+    time_ticks_t time;
+    const char *name;
+    const void *source;
+    char phase; //'B' begin, 'E' end, 'i' instant
+};
+
+//! Events from one recording thread
+struct TraceThreadEvents
+{
+    size_t thread_index;
+    size_t num_dropped;
+    std::vector<TraceEvent> events;
+};
+
+//! Is a trace being captured right now?
+extern volatile bool trace_capturing;
+
+//! The longest capture, so that a client can not hold a thread for long
+static const double TRACE_MAX_SECONDS = 10.0;
+
+//! Record an event into the calling thread's ring
+void trace_record(const char *name, const char phase, const void *source);
+
+/*!
+ * Capture scheduler events for a duration in seconds.
+ * The duration is clamped to [0, TRACE_MAX_SECONDS].
+ * Only one capture runs at a time, others wait their turn.
+ * \return the events from each thread that recorded any
+ */
+std::vector<TraceThreadEvents> trace_capture(const double seconds);
+
+GRAS_FORCE_INLINE void trace_instant(const char *name, const void *source)
+{
+    if GRAS_UNLIKELY(trace_capturing) trace_record(name, 'i', source);
+}
+
+//! Record a begin and end event around a scope
+struct TraceScope
+{
+    GRAS_FORCE_INLINE TraceScope(const char *name, const void *source):
+        name(name),
+        source(source),
+        active(trace_capturing)
+    {
+        if GRAS_UNLIKELY(active) trace_record(name, 'B', source);
+    }
+
+    GRAS_FORCE_INLINE ~TraceScope(void)
+    {
+        if GRAS_UNLIKELY(active) trace_record(name, 'E', source);
+    }
+
+    const char *name;
+    const void *source;
+    const bool active;
+};
+
+} //namespace gras
+
+#endif /*INCLUDED_LIBGRAS_IMPL_TRACE_HPP*/
@@ -0,0 +1,36 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+//! Write the manifest of a module: the factory paths that it registers.
+//! Usage: gras_module_manifest <module> <manifest>
+
+#include <gras/factory.hpp>
+#include <boost/foreach.hpp>
+#include <stdexcept>
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+
+int main(int argc, char *argv[])
+{
+    if (argc != 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " <module> <manifest>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try
+    {
+        const std::vector<std::string> paths = gras::load_module(argv[1]);
+        if (paths.empty()) std::cerr << "Warning: " << argv[1] << " registered no factory paths, it will load eagerly" << std::endl;
+        std::ofstream manifest(argv[2]);
+        if (not manifest.is_open()) throw std::runtime_error(std::string("cannot write ") + argv[2]);
+        manifest << "# GRAS module manifest: the factory paths registered by the module" << std::endl;
+        BOOST_FOREACH(const std::string &path, paths) manifest << path << std::endl;
+    }
+    catch (const std::exception &ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
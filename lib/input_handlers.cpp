@@ -9,25 +9,38 @@ void BlockActor::handle_input_tag(const InputTagMessage &message, const Theron::
 {
     TimerAccumulate ta(data->stats.total_time_input);
     MESSAGE_TRACER();
+    this->update_stats(ta.start);
+    trace_instant("input_tag", this);
     const size_t index = message.index;
 
     //handle incoming stream tag, push into the tag storage
     if GRAS_UNLIKELY(data->block_state == BLOCK_STATE_DONE) return;
-    data->input_tags[index].push_back(message.tag);
-    data->input_tags_changed[index] = true;
+    if GRAS_UNLIKELY(data->message_only) return;
+    data->input_tags[index].push(message.tags.begin(), message.tags.end());
 }
 
 void BlockActor::handle_input_msg(const InputMsgMessage &message, const Theron::Address)
 {
     TimerAccumulate ta(data->stats.total_time_input);
     MESSAGE_TRACER();
+    this->update_stats(ta.start);
+    trace_instant("input_msg", this);
     const size_t index = message.index;
 
     //handle incoming async message, push into the msg storage
     if GRAS_UNLIKELY(data->block_state == BLOCK_STATE_DONE) return;
-    data->input_msgs[index].push_back(message.msg);
+    data->input_msgs[index].push(MsgEntry(message.msg, message.slot));
+    this->update_msg_pressure(index);
+
     this->update_input_avail(index);
 
+    //message-only blocks skip the stream bookkeeping
+    if (data->message_only)
+    {
+        ta.done();
+        this->task_msgs();
+        return;
+    }
     ta.done();
     this->task_main();
 }
@@ -36,10 +49,26 @@ void BlockActor::handle_input_buffer(const InputBufferMessage &message, const Th
 {
     TimerAccumulate ta(data->stats.total_time_input);
     MESSAGE_TRACER();
+    this->update_stats(ta.start);
+    trace_instant("input_buffer", this);
     const size_t index = message.index;
 
     //handle incoming stream buffer, push into the queue
+    //the tags for these items travel with the buffer
     if GRAS_UNLIKELY(data->block_state == BLOCK_STATE_DONE) return;
+    if GRAS_UNLIKELY(data->message_only) return; //release the buffer upstream
+    if GRAS_UNLIKELY(not message.tags.empty())
+    {
+        data->input_tags[index].push(message.tags.begin(), message.tags.end());
+    }
+    if GRAS_UNLIKELY(message.produce_time != 0 and data->latency_tracking)
+    {
+        LatencyStamp stamp;
+        stamp.produce_time = message.produce_time;
+        stamp.origin_time = message.origin_time;
+        stamp.bytes = message.buffer.length;
+        data->input_latency_stamps[index].push_back(stamp);
+    }
     data->input_queues.push(index, message.buffer);
     this->update_input_avail(index);
 
@@ -51,6 +80,7 @@ void BlockActor::handle_input_token(const InputTokenMessage &message, const Ther
 {
     TimerAccumulate ta(data->stats.total_time_input);
     MESSAGE_TRACER();
+    this->update_stats(ta.start);
     ASSERT(message.index < worker->get_num_inputs());
 
     //store the token of the upstream producer
@@ -61,6 +91,8 @@ void BlockActor::handle_input_check(const InputCheckMessage &message, const Ther
 {
     TimerAccumulate ta(data->stats.total_time_input);
     MESSAGE_TRACER();
+    this->update_stats(ta.start);
+    trace_instant("input_check", this);
     const size_t index = message.index;
 
     //record time of the first input declared done
@@ -91,6 +123,7 @@ void BlockActor::handle_input_alloc(const InputAllocMessage &message, const Ther
 {
     TimerAccumulate ta(data->stats.total_time_input);
     MESSAGE_TRACER();
+    this->update_stats(ta.start);
     const size_t index = message.index;
 
     //new token for this downstream allocator
@@ -110,13 +143,49 @@ void BlockActor::handle_input_update(const InputUpdateMessage &message, const Th
 {
     TimerAccumulate ta(data->stats.total_time_input);
     MESSAGE_TRACER();
+    this->update_stats(ta.start);
     const size_t i = message.index;
 
     //update buffer queue configuration
     if (i >= data->input_queues.size()) return;
-    const size_t preload_bytes = data->input_configs[i].item_size*data->input_configs[i].preload_items;
-    const size_t reserve_bytes = data->input_configs[i].item_size*data->input_configs[i].reserve_items;
+    const bool packet_stream = data->input_configs[i].packet_stream;
+    const size_t preload_bytes = packet_stream? 0 : data->input_configs[i].item_size*data->input_configs[i].preload_items;
+    const size_t reserve_items = packet_stream? std::min<size_t>(data->input_configs[i].reserve_items, 1) : data->input_configs[i].reserve_items;
+    const size_t reserve_bytes = data->input_configs[i].item_size*reserve_items;
     const size_t maximum_bytes = data->input_configs[i].item_size*data->input_configs[i].maximum_items;
     data->input_queues.update_config(i, data->input_configs[i].item_size, preload_bytes, reserve_bytes, maximum_bytes);
     this->update_input_avail(i);
+
+    //update the msg queue depth
+    data->input_msgs[i].set_depth(data->input_configs[i].maximum_msgs);
+    this->update_msg_pressure(i);
+
+    //the tag subscription may have changed, tell the upstream
+    this->post_input_hint(i);
+}
+
+void BlockActor::post_input_hint(const size_t i)
+{
+    //no upstream subscriber yet, hints are posted on topology token
+    if (not data->input_tokens[i]) return;
+
+    //this port wants its own tags, and anything that the
+    //downstream wants, since tags may be propagated through
+    //a message-only block discards all tags, so it wants none
+    TagSubscription tag_subscription(data->input_configs[i]);
+    BOOST_FOREACH(const TagSubscription &output_subscription, data->output_tag_subscriptions)
+    {
+        tag_subscription.merge(output_subscription);
+    }
+    if (data->block->global_config().message_only)
+    {
+        tag_subscription.all = false;
+        tag_subscription.keys.clear();
+    }
+
+    OutputHintMessage output_hints;
+    output_hints.reserve_bytes = data->input_configs[i].reserve_items*data->input_configs[i].item_size;
+    output_hints.tag_subscription = tag_subscription;
+    output_hints.token = data->input_tokens[i];
+    worker->post_upstream(i, output_hints);
 }
@@ -1,17 +1,39 @@
 // Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
 
 #include <gras/factory.hpp>
+#include <gras_impl/call_future.hpp>
 #include <boost/foreach.hpp>
 #include <boost/format.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/bind.hpp>
 #include <stdexcept>
 #include <iostream>
 #include <cstdio>
+#include <cstdlib>
+#include <cctype>
+#include <ctime>
 #include <fstream>
+#include <sstream>
+#include <iterator>
+#include <algorithm>
 #include <map>
 
+#ifdef _MSC_VER
+#define popen _popen
+#define pclose _pclose
+#endif
+
+namespace fs = boost::filesystem;
+
+#ifndef BOOST_WINDOWS_API
+#include <dlfcn.h>
+#endif
+
 //defined in module loader
 std::string get_gras_runtime_include_path(void);
+std::string get_gras_version(void);
 
 #ifdef HAVE_CLANG
 #include <clang/CodeGen/CodeGenAction.h>
@@ -58,16 +80,39 @@ struct ExecutionEngineMonitor
         ees.clear();
     }
 
-    void add(boost::shared_ptr<llvm::ExecutionEngine> ee)
+    /*!
+     * Parse bitcodes into execution engines and run their static constructors.
+     * All of the bitcodes are parsed and jitted before any constructors run,
+     * so a bad bitcode does not leave some of the factories registered.
+     */
+    void load(const std::vector<std::string> &bitcodes)
     {
+        //the context is not thread-safe, only the compiler runs in parallel
         boost::mutex::scoped_lock l(mutex);
-        ee->runStaticConstructorsDestructors(false);
-        ees.push_back(ee);
-    }
 
-    llvm::LLVMContext &get_context(void)
-    {
-        return context;
+        std::vector<boost::shared_ptr<llvm::ExecutionEngine> > new_ees;
+        BOOST_FOREACH(const std::string &bitcode, bitcodes)
+        {
+            //create a memory buffer from the bitcode
+            boost::shared_ptr<llvm::MemoryBuffer> buffer(llvm::MemoryBuffer::getMemBuffer(bitcode));
+
+            //parse the bitcode into a module
+            std::string error;
+            llvm::Module *module = llvm::ParseBitcodeFile(buffer.get(), context, &error);
+            if (not error.empty()) throw std::runtime_error("GRAS compiler: ParseBitcodeFile " + error);
+
+            //create execution engine
+            boost::shared_ptr<llvm::ExecutionEngine> ee(llvm::ExecutionEngine::create(module, false, &error));
+            if (not error.empty()) throw std::runtime_error("GRAS compiler: ExecutionEngine " + error);
+            new_ees.push_back(ee);
+        }
+
+        std::cout << "GRAS compiler: execute static constructors..." << std::endl;
+        BOOST_FOREACH(boost::shared_ptr<llvm::ExecutionEngine> ee, new_ees)
+        {
+            ee->runStaticConstructorsDestructors(false);
+            ees.push_back(ee);
+        }
     }
 
     boost::mutex mutex;
@@ -82,20 +127,52 @@ static ExecutionEngineMonitor &get_eemon(void)
 }
 #endif //HAVE_LLVM
 
+/***********************************************************************
+ * Helper functions for the compiler and its version
+ **********************************************************************/
+#ifdef HAVE_LLVM
+static std::string get_clang_path(void)
+{
+    llvm::sys::Path clangPath = llvm::sys::Program::FindProgramByName("clang");
+    return clangPath.str();
+}
+
+//! Run a command and return its standard output
+static std::string read_command_output(const std::string &command)
+{
+    std::string output;
+    FILE *p = popen(command.c_str(), "r");
+    if (p == NULL) return output;
+    char buff[4096];
+    size_t n;
+    while ((n = std::fread(buff, 1, sizeof(buff), p)) > 0) output.append(buff, n);
+    pclose(p);
+    return output;
+}
+
+//! The version banner of clang, queried once per process
+static const std::string &get_clang_version(void)
+{
+    static boost::mutex mutex;
+    static std::string version;
+    boost::mutex::scoped_lock l(mutex);
+    if (version.empty()) version = read_command_output("\"" + get_clang_path() + "\" --version");
+    return version;
+}
+#endif //HAVE_LLVM
+
 /***********************************************************************
  * Helper function to call a clang compliation -- execs clang
  **********************************************************************/
 #ifdef HAVE_LLVM
-static llvm::Module *call_clang_exe(const std::string &source_file, const std::vector<std::string> &flags)
+static std::string call_clang_exe(const std::string &source_file, const std::vector<std::string> &flags, const std::string &deps_file)
 {
     //make up bitcode file path
-    char bitcode_file[L_tmpnam];
-    if (std::tmpnam(bitcode_file) == NULL) throw std::runtime_error("GRAS compiler: tmp bitcode file path failed");
+    const fs::path bitcode_file = fs::temp_directory_path() / fs::unique_path("gras-jit-%%%%-%%%%-%%%%.bc");
 
     //begin command setup
     std::vector<std::string> cmd;
-    llvm::sys::Path clangPath = llvm::sys::Program::FindProgramByName("clang");
-    cmd.push_back(clangPath.str());
+    cmd.push_back(get_clang_path());
     cmd.push_back("-emit-llvm");
 
     //inject source
@@ -106,7 +183,15 @@ static llvm::Module *call_clang_exe(const std::string &source_file, const std::v
 
     //inject output
     cmd.push_back("-o");
-    cmd.push_back(bitcode_file);
+    cmd.push_back(bitcode_file.string());
+
+    //list the included headers as a make rule
+    if (not deps_file.empty())
+    {
+        cmd.push_back("-MD");
+        cmd.push_back("-MF");
+        cmd.push_back(deps_file);
+    }
 
     //inject args...
     BOOST_FOREACH(const std::string &flag, flags)
@@ -121,24 +206,32 @@ static llvm::Module *call_clang_exe(const std::string &source_file, const std::v
         command += c + " ";
     }
     std::cout << "  " << command << std::endl;
-    const int ret = system(command.c_str());
+
+    //capture the diagnostics so errors can carry them
+    std::string diagnostics;
+    FILE *p = popen((command + " 2>&1").c_str(), "r");
+    if (p == NULL) throw std::runtime_error("GRAS compiler: error exec clang");
+    char buff[4096];
+    size_t n;
+    while ((n = std::fread(buff, 1, sizeof(buff), p)) > 0) diagnostics.append(buff, n);
+    const int ret = pclose(p);
     if (ret != 0)
     {
-        throw std::runtime_error("GRAS compiler: error system exec clang");
+        boost::system::error_code ec;
+        fs::remove(bitcode_file, ec);
+        throw std::runtime_error("GRAS compiler: error exec clang\n" + diagnostics);
     }
+    if (not diagnostics.empty()) std::cerr << diagnostics << std::flush;
 
     //readback bitcode for result
-    std::ifstream bitcode_fstream(bitcode_file);
-    const std::string bitcode((std::istreambuf_iterator<char>(bitcode_fstream)), std::istreambuf_iterator<char>());
-
-    //create a memory buffer from the bitcode
-    boost::shared_ptr<llvm::MemoryBuffer> buffer(llvm::MemoryBuffer::getMemBuffer(bitcode));
-
-    //parse the bitcode into a module
-    std::string error;
-    llvm::Module *module = llvm::ParseBitcodeFile(buffer.get(), get_eemon().get_context(), &error);
-    if (not error.empty()) throw std::runtime_error("GRAS compiler: ParseBitcodeFile " + error);
-    return module;
+    std::string bitcode;
+    {
+        std::ifstream bitcode_fstream(bitcode_file.string().c_str(), std::ios::in | std::ios::binary);
+        bitcode.assign((std::istreambuf_iterator<char>(bitcode_fstream)), std::istreambuf_iterator<char>());
+    }
+    boost::system::error_code ec;
+    fs::remove(bitcode_file, ec);
+    return bitcode;
 }
 #endif //HAVE_LLVM
 
@@ -203,34 +296,356 @@ static llvm::Module *call_clang_api(const std::string &source_file, const std::v
 #endif //HAVE_CLANG
 */
 
+/***********************************************************************
+ * Bitcode cache on disk
+ **********************************************************************/
+#ifdef HAVE_LLVM
+
+static const char *JIT_CACHE_HEADER = "gras jit cache 1";
+static const char *JIT_CACHE_EXT = ".jit";
+static const boost::uintmax_t JIT_CACHE_MAX_BYTES = 256*1024*1024;
+
+//! The cache directory, or an empty path when the cache is disabled
+static fs::path get_jit_cache_dir(void)
+{
+    const char *cache_env = std::getenv("GRAS_JIT_CACHE");
+    if (cache_env != NULL) return fs::path(cache_env);
+    const char *home_env = std::getenv("HOME");
+    if (home_env == NULL) home_env = std::getenv("APPDATA");
+    if (home_env == NULL) return fs::temp_directory_path() / "gras_jit_cache";
+    return fs::path(home_env) / ".gras" / "jit_cache";
+}
+
+//! A 128 bit FNV-1a hash of the key material as hex digits
+static std::string jit_cache_hash(const std::string &material)
+{
+    unsigned long long h0 = 14695981039346656037ULL;
+    unsigned long long h1 = 6151214081604590541ULL;
+    BOOST_FOREACH(const char ch, material)
+    {
+        h0 = (h0 ^ (unsigned char)(ch)) * 1099511628211ULL;
+        h1 = (h1 ^ (unsigned char)(ch)) * 1099511628211ULL;
+        h1 ^= h1 >> 29;
+    }
+    return str(boost::format("%016x%016x") % h0 % h1);
+}
+
+//! Parse the headers out of a make rule that clang wrote with -MD
+static bool read_dependency_file(const fs::path &deps_file, const std::string &source_file, std::vector<std::string> &deps)
+{
+    std::string rule;
+    {
+        std::ifstream deps_fstream(deps_file.string().c_str());
+        rule.assign((std::istreambuf_iterator<char>(deps_fstream)), std::istreambuf_iterator<char>());
+    }
+
+    //the rule is "target: dep dep \<newline> dep", with escaped spaces in paths
+    const size_t colon = rule.find(": ");
+    if (colon == std::string::npos) return false;
+    std::string dep;
+    for (size_t i = colon+2; i <= rule.size(); i++)
+    {
+        const char ch = (i < rule.size())? rule[i] : ' ';
+        if (ch == '\\' and i+1 < rule.size() and rule[i+1] == ' ') dep += rule[++i];
+        else if (ch == '\\' and i+1 < rule.size() and (rule[i+1] == '\n' or rule[i+1] == '\r')) continue;
+        else if (std::isspace(ch))
+        {
+            if (not dep.empty() and dep != source_file) deps.push_back(dep);
+            dep.clear();
+        }
+        else dep += ch;
+    }
+    return true;
+}
+
+//! The size and modification time of a file, which change when it is edited
+static std::string jit_cache_stamp(const std::string &path)
+{
+    boost::system::error_code ec;
+    const boost::uintmax_t size = fs::file_size(path, ec);
+    const std::time_t mtime = fs::last_write_time(path, ec);
+    return str(boost::format("%u\t%d") % size % (long long)(mtime));
+}
+
+//! The path of the gras library file that is loaded in this process
+static std::string get_gras_library_path(void)
+{
+    #ifdef BOOST_WINDOWS_API
+    return "";
+    #else
+    Dl_info info;
+    if (dladdr(reinterpret_cast<void *>(&gras::jit_factory), &info) == 0 or info.dli_fname == NULL) return "";
+    return info.dli_fname;
+    #endif
+}
+
+/*!
+ * The cache entry path for a compilation, keyed by the source, the flags,
+ * the compiler and GRAS versions, and the stamp of the gras library file,
+ * so rebuilding GRAS with a changed block layout misses the cache.
+ * The included headers are not known before a compile,
+ * so they are listed in the entry and checked on a lookup.
+ */
+static fs::path get_jit_cache_file(const fs::path &cache_dir, const std::string &source, const std::vector<std::string> &flags)
+{
+    std::ostringstream material;
+    material << "gras " << get_gras_version() << '\0';
+    material << get_gras_library_path() << '\0' << jit_cache_stamp(get_gras_library_path()) << '\0';
+    material << "clang " << get_clang_version() << '\0';
+    BOOST_FOREACH(const std::string &flag, flags) material << flag << '\0';
+    material << source;
+    return cache_dir / (jit_cache_hash(material.str()) + JIT_CACHE_EXT);
+}
+
+/*!
+ * Read a cache entry: a header line, the number of included headers,
+ * a stamp and path line per header, and then the bitcode.
+ * \return false on a miss, or when any header has changed since
+ */
+static bool jit_cache_read(const fs::path &cache_file, std::string &bitcode)
+{
+    std::ifstream cache_fstream(cache_file.string().c_str(), std::ios::in | std::ios::binary);
+    if (not cache_fstream.is_open()) return false;
+
+    std::string line;
+    if (not std::getline(cache_fstream, line) or line != JIT_CACHE_HEADER) return false;
+    size_t num_deps = 0;
+    if (not std::getline(cache_fstream, line)) return false;
+    std::istringstream(line) >> num_deps;
+    for (size_t i = 0; i < num_deps; i++)
+    {
+        if (not std::getline(cache_fstream, line)) return false;
+        const size_t tab = line.find('\t', line.find('\t')+1);
+        if (tab == std::string::npos) return false;
+        if (jit_cache_stamp(line.substr(tab+1)) != line.substr(0, tab)) return false; //stale
+    }
+    bitcode.assign((std::istreambuf_iterator<char>(cache_fstream)), std::istreambuf_iterator<char>());
+    if (bitcode.empty()) return false;
+
+    //a hit is recently used, which keeps it from eviction
+    boost::system::error_code ec;
+    fs::last_write_time(cache_file, std::time(NULL), ec);
+    return true;
+}
+
+//! Remove the least recently used entries while the cache is over its size limit
+static void jit_cache_evict(const fs::path &cache_dir)
+{
+    boost::system::error_code ec;
+    std::vector<std::pair<std::time_t, fs::path> > entries;
+    boost::uintmax_t total_bytes = 0;
+    for (fs::directory_iterator it(cache_dir, ec); not ec and it != fs::directory_iterator(); it.increment(ec))
+    {
+        if (it->path().extension() != JIT_CACHE_EXT) continue;
+        total_bytes += fs::file_size(it->path(), ec);
+        entries.push_back(std::make_pair(fs::last_write_time(it->path(), ec), it->path()));
+    }
+    std::sort(entries.begin(), entries.end());
+    for (size_t i = 0; i < entries.size() and total_bytes > JIT_CACHE_MAX_BYTES; i++)
+    {
+        const boost::uintmax_t bytes = fs::file_size(entries[i].second, ec);
+        if (fs::remove(entries[i].second, ec)) total_bytes -= bytes;
+    }
+}
+
+static void jit_cache_write(const fs::path &cache_file, const std::vector<std::string> &deps, const std::string &bitcode)
+{
+    //write a unique temp file and rename it into place,
+    //so that concurrent processes never see a partial file
+    boost::system::error_code ec;
+    fs::create_directories(cache_file.parent_path(), ec);
+    const fs::path tmp_file = cache_file.parent_path() / fs::unique_path("%%%%-%%%%-%%%%.tmp");
+    {
+        std::ofstream tmp_fstream(tmp_file.string().c_str(), std::ios::out | std::ios::binary);
+        if (not tmp_fstream.is_open()) return; //not writable, just skip the cache
+        tmp_fstream << JIT_CACHE_HEADER << "\n" << deps.size() << "\n";
+        BOOST_FOREACH(const std::string &dep, deps) tmp_fstream << jit_cache_stamp(dep) << "\t" << dep << "\n";
+        tmp_fstream.write(bitcode.data(), bitcode.size());
+        tmp_fstream.close();
+
+        //a short write (like a full disk) must never become a cache hit
+        if (not tmp_fstream.good())
+        {
+            fs::remove(tmp_file, ec);
+            return;
+        }
+    }
+    fs::rename(tmp_file, cache_file, ec);
+    if (ec) fs::remove(tmp_file, ec);
+    else jit_cache_evict(cache_file.parent_path());
+}
+
+/*!
+ * Compile source into bitcode, or get the bitcode from the cache.
+ * \param [out] cache_hit the cache entry when the bitcode came from it
+ */
+static std::string jit_compile(const std::string &source, const std::vector<std::string> &flags, fs::path &cache_hit)
+{
+    cache_hit = fs::path();
+    const fs::path cache_dir = get_jit_cache_dir();
+    const fs::path cache_file = cache_dir.empty()? fs::path() : get_jit_cache_file(cache_dir, source, flags);
+    std::string bitcode;
+    if (not cache_file.empty() and jit_cache_read(cache_file, bitcode))
+    {
+        std::cout << "GRAS compiler: load cached bitcode " << cache_file.string() << std::endl;
+        cache_hit = cache_file;
+        return bitcode;
+    }
+
+    //write source to tmp file
+    const fs::path source_file = fs::temp_directory_path() / fs::unique_path("gras-jit-%%%%-%%%%-%%%%.cpp");
+    const fs::path deps_file = fs::path(source_file).replace_extension(".d");
+    {
+        std::ofstream source_fstream(source_file.string().c_str());
+        source_fstream << source;
+    }
+
+    //use clang to compile source into bitcode,
+    //the compile also lists the included headers for the cache entry
+    std::cout << "GRAS compiler: compile source into bitcode..." << std::endl;
+    try
+    {
+        bitcode = call_clang_exe(source_file.string(), flags, cache_file.empty()? "" : deps_file.string());
+        std::vector<std::string> deps;
+        if (not cache_file.empty() and read_dependency_file(deps_file, source_file.string(), deps))
+        {
+            jit_cache_write(cache_file, deps, bitcode);
+        }
+    }
+    catch (...)
+    {
+        boost::system::error_code ec;
+        fs::remove(source_file, ec);
+        fs::remove(deps_file, ec);
+        throw;
+    }
+    boost::system::error_code ec;
+    fs::remove(source_file, ec);
+    fs::remove(deps_file, ec);
+    return bitcode;
+}
+
+/*!
+ * Load compiled bitcodes into the execution engines.
+ * A cached bitcode that does not load is a bad cache entry:
+ * the entries that were hits are removed, and their sources compile again.
+ */
+static void jit_load(const std::vector<std::string> &sources, const std::vector<std::string> &flags, std::vector<std::string> &bitcodes, const std::vector<fs::path> &cache_hits)
+{
+    try
+    {
+        return get_eemon().load(bitcodes);
+    }
+    catch (const std::exception &ex)
+    {
+        if (std::count(cache_hits.begin(), cache_hits.end(), fs::path()) == std::ptrdiff_t(cache_hits.size())) throw;
+        std::cerr << "GRAS compiler: discard cached bitcode, " << ex.what() << std::endl;
+    }
+    for (size_t i = 0; i < sources.size(); i++)
+    {
+        if (cache_hits[i].empty()) continue;
+        boost::system::error_code ec;
+        fs::remove(cache_hits[i], ec);
+        fs::path cache_hit;
+        bitcodes[i] = jit_compile(sources[i], flags, cache_hit);
+    }
+    get_eemon().load(bitcodes);
+}
+
+#endif //HAVE_LLVM
+
 /***********************************************************************
  * factory compile implementation
  **********************************************************************/
 #ifdef HAVE_LLVM
 void gras::jit_factory(const std::string &source, const std::vector<std::string> &flags_)
 {
-    //write source to tmp file
-    char source_file[L_tmpnam];
-    if (std::tmpnam(source_file) == NULL) throw std::runtime_error("GRAS compiler: tmp source file path failed");
-    std::ofstream source_fstream(source_file);
-    source_fstream << source;
-    source_fstream.close();
+    llvm::InitializeNativeTarget();
+    llvm::llvm_start_multithreaded();
+
+    std::vector<std::string> flags = flags_;
+    flags.push_back("-I"+get_gras_runtime_include_path()); //add root include path
+    std::vector<fs::path> cache_hits(1);
+    std::vector<std::string> bitcodes(1, jit_compile(source, flags, cache_hits[0]));
+    jit_load(std::vector<std::string>(1, source), flags, bitcodes, cache_hits);
+}
 
+/*!
+ * The shared state of a batch compile:
+ * each worker takes the next source until all are taken,
+ * so at most one clang process runs per worker.
+ */
+struct JitBatch
+{
+    JitBatch(const std::vector<std::string> &sources, const std::vector<std::string> &flags):
+        sources(sources),
+        flags(flags),
+        next(0),
+        bitcodes(sources.size()),
+        cache_hits(sources.size()),
+        errors(sources.size())
+    {}
+
+    void worker(void)
+    {
+        while (true)
+        {
+            size_t i;
+            {
+                boost::mutex::scoped_lock l(mutex);
+                if (next == sources.size()) return;
+                i = next++;
+            }
+            try
+            {
+                bitcodes[i] = jit_compile(sources[i], flags, cache_hits[i]);
+            }
+            catch (const std::exception &ex)
+            {
+                errors[i] = ex.what();
+            }
+        }
+    }
+
+    const std::vector<std::string> &sources;
+    const std::vector<std::string> &flags;
+    boost::mutex mutex;
+    size_t next;
+    std::vector<std::string> bitcodes;
+    std::vector<fs::path> cache_hits;
+    std::vector<std::string> errors;
+};
+
+void gras::jit_factory_batch(const std::vector<std::string> &sources, const std::vector<std::string> &flags_)
+{
     llvm::InitializeNativeTarget();
     llvm::llvm_start_multithreaded();
 
-    //use clang to compile source into bitcode
-    std::cout << "GRAS compiler: compile source into bitcode..." << std::endl;
     std::vector<std::string> flags = flags_;
     flags.push_back("-I"+get_gras_runtime_include_path()); //add root include path
-    llvm::Module *module = call_clang_exe(source_file, flags);
 
-    //create execution engine
-    std::string error;
-    boost::shared_ptr<llvm::ExecutionEngine> ee(llvm::ExecutionEngine::create(module, false, &error));
-    if (not error.empty()) throw std::runtime_error("GRAS compiler: ExecutionEngine " + error);
-    std::cout << "GRAS compiler: execute static constructors..." << std::endl;
-    get_eemon().add(ee);
+    //compile in parallel, each worker thread runs one clang process at a time
+    JitBatch batch(sources, flags);
+    const size_t num_workers = std::min<size_t>(sources.size(), std::max<size_t>(1, boost::thread::hardware_concurrency()));
+    std::cout << "GRAS compiler: compile " << sources.size() << " sources with " << num_workers << " workers..." << std::endl;
+    boost::thread_group workers;
+    for (size_t i = 0; i < num_workers; i++)
+    {
+        workers.create_thread(boost::bind(&JitBatch::worker, &batch));
+    }
+    workers.join_all();
+
+    //aggregate the diagnostics of every failed source
+    std::string errors;
+    for (size_t i = 0; i < sources.size(); i++)
+    {
+        if (batch.errors[i].empty()) continue;
+        errors += str(boost::format("source %u: %s\n") % i % batch.errors[i]);
+    }
+    if (not errors.empty()) throw std::runtime_error("GRAS compiler: batch failed, nothing was loaded\n" + errors);
+
+    //load all of the factories together
+    jit_load(sources, flags, batch.bitcodes, batch.cache_hits);
 }
 
 #else //HAVE_LLVM
@@ -240,4 +655,33 @@ void gras::jit_factory(const std::string &, const std::vector<std::string> &)
     throw std::runtime_error("GRAS compiler not built with Clang support!");
 }
 
+void gras::jit_factory_batch(const std::vector<std::string> &, const std::vector<std::string> &)
+{
+    throw std::runtime_error("GRAS compiler not built with Clang support!");
+}
+
 #endif //HAVE_LLVM
+
+/***********************************************************************
+ * factory compile in the background
+ **********************************************************************/
+static void jit_factory_task(const std::string &source, const std::vector<std::string> &flags, gras::CallFuture future)
+{
+    try
+    {
+        gras::jit_factory(source, flags);
+        future->set_value(PMCC());
+    }
+    catch (const std::exception &ex)
+    {
+        future->set_error(ex.what());
+    }
+}
+
+gras::CallFuture gras::jit_factory_async(const std::string &source, const std::vector<std::string> &flags)
+{
+    gras::CallFuture future;
+    future.reset(new gras::CallFutureImpl("jit_factory"));
+    boost::thread(boost::bind(&jit_factory_task, source, flags, future)).detach();
+    return future;
+}
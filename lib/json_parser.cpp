@@ -13,7 +13,6 @@
 #include "gras_impl/debug.hpp"
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
-#include <boost/regex.hpp>
 #include <sstream>
 #include <string>
 
@@ -24,14 +23,3 @@ boost::property_tree::ptree gras::json_to_ptree(const std::string &s)
     boost::property_tree::json_parser::read_json(ss, pt);
     return pt;
 }
-
-//http://stackoverflow.com/questions/13464383/boost-property-write-json-incorrect-behaviour
-std::string gras::ptree_to_json(const boost::property_tree::ptree &p)
-{
-    boost::regex exp("\"(null|true|false|[0-9]+(\\.[0-9]+)?)\"");
-    std::stringstream ss;
-    boost::property_tree::json_parser::write_json(ss, p);
-    std::string rv = boost::regex_replace(ss.str(), exp, "$1");
-
-    return rv;
-}
@@ -1,15 +1,26 @@
 // Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
 
 #include <gras/gras.hpp>
+#include <gras/factory.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/tokenizer.hpp>
 #include <boost/foreach.hpp>
+#include <boost/thread/recursive_mutex.hpp>
 #include <stdexcept>
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include <cstdlib>
+#include <ctime>
+#include <algorithm>
+#include <utility>
+#include <map>
 
 namespace fs = boost::filesystem;
 
+//defined in factory
+std::vector<std::string> get_registered_factory_paths(void);
+
 #ifdef BOOST_WINDOWS_API
     #include <windows.h>
     static const char *SEP = ";";
@@ -17,6 +28,10 @@ namespace fs = boost::filesystem;
     {
         return LoadLibrary(path) != NULL;
     }
+    static std::string module_load_error(void)
+    {
+        return "LoadLibrary failed";
+    }
 #else
     #include <dlfcn.h>
     static const char *SEP = ":";
@@ -24,59 +39,322 @@ namespace fs = boost::filesystem;
     {
         return dlopen(path, RTLD_LAZY) != NULL;
     }
+    static std::string module_load_error(void)
+    {
+        const char *err = dlerror();
+        return (err == NULL)? "dlopen failed" : err;
+    }
 #endif
 
-static void load_all_modules_in_path(const fs::path &path)
+static std::string my_get_env(const std::string &name, const std::string &defalt)
 {
+    const char *env_var = std::getenv(name.c_str());
+    return (env_var != NULL)? env_var : defalt;
+}
+
+//used by jit factory, but defined here for lazyness
+std::string get_gras_runtime_include_path(void)
+{
+    const std::string root = my_get_env("GRAS_ROOT", "@GRAS_ROOT@");
+    const fs::path inc_path = fs::path(root) / "include";
+    return inc_path.string();
+}
+
+//used by jit factory cache keys
+std::string get_gras_version(void)
+{
+    return "@GRAS_VERSION@";
+}
+
+/***********************************************************************
+ * The module index:
+ * Modules with a manifest are indexed by their factory paths,
+ * and only load on the first make() of one of those paths.
+ * Modules without a manifest load when GRAS loads, like always.
+ **********************************************************************/
+struct ModuleIndex
+{
+    std::vector<std::string> eager_modules;
+    std::map<std::string, std::string> lazy_modules; //factory path -> module
+    std::vector<std::pair<std::time_t, std::string> > stamps; //checked for changes
+};
+
+//! The factory paths that each loaded module registered, by canonical file path
+typedef std::map<std::string, std::vector<std::string> > LoadedModules;
+
+static ModuleIndex &get_module_index(void)
+{
+    static ModuleIndex index;
+    return index;
+}
+
+static LoadedModules &get_loaded_modules(void)
+{
+    static LoadedModules loaded;
+    return loaded;
+}
+
+//protects the index, recursive for modules that make() from static constructors
+static boost::recursive_mutex loader_mutex;
+
+static const std::string MANIFEST_EXT = ".manifest";
+
+static std::time_t get_time_stamp(const fs::path &path)
+{
+    boost::system::error_code ec;
+    const std::time_t t = fs::last_write_time(path, ec);
+    return ec? std::time_t(0) : t;
+}
+
+/*!
+ * Read the factory paths from a manifest: one path per line, # comments.
+ * A module whose manifest is empty or unreadable could never load on demand,
+ * so it loads eagerly like a module without a manifest.
+ */
+static void read_manifest(const fs::path &manifest, const std::string &mod_path, ModuleIndex &index)
+{
+    std::vector<std::string> paths;
+    std::ifstream manifest_fstream(manifest.string().c_str());
+    std::string line;
+    while (std::getline(manifest_fstream, line))
+    {
+        const size_t begin = line.find_first_not_of(" \t\r");
+        if (begin == std::string::npos or line[begin] == '#') continue;
+        const size_t end = line.find_last_not_of(" \t\r");
+        paths.push_back(line.substr(begin, end-begin+1));
+    }
+
+    if (paths.empty())
+    {
+        std::cerr << "GRAS Module loader: empty or unreadable manifest " << manifest.string() << std::endl;
+        index.eager_modules.push_back(mod_path);
+        return;
+    }
+    BOOST_FOREACH(const std::string &path, paths) index.lazy_modules[path] = mod_path;
+}
+
+static void index_all_modules_in_path(const fs::path &path, ModuleIndex &index)
+{
+    index.stamps.push_back(std::make_pair(get_time_stamp(path), path.string()));
     if (not fs::exists(path)) return;
     if (fs::is_regular_file(path))
     {
         const std::string mod_path = path.string();
-        if (not load_module_in_path(mod_path.c_str()))
-        {
-            std::cerr << "GRAS Module loader fail: " << mod_path << std::endl;
-        }
+        if (path.extension() == MANIFEST_EXT) return;
+        const fs::path manifest(mod_path + MANIFEST_EXT);
+        index.stamps.push_back(std::make_pair(get_time_stamp(manifest), manifest.string()));
+        if (fs::is_regular_file(manifest)) read_manifest(manifest, mod_path, index);
+        else index.eager_modules.push_back(mod_path);
         return;
     }
     if (fs::is_directory(path)) for(
         fs::directory_iterator dir_itr(path);
         dir_itr != fs::directory_iterator();
         ++dir_itr
-    ) load_all_modules_in_path(dir_itr->path());
+    ) index_all_modules_in_path(dir_itr->path(), index);
 }
 
-static void load_modules_from_paths(const std::string &paths, const fs::path &suffix)
+static void index_modules_from_paths(const std::string &paths, const fs::path &suffix, ModuleIndex &index)
 {
     if (paths.empty()) return;
     BOOST_FOREACH(const std::string &path, boost::tokenizer<boost::char_separator<char> > (paths, boost::char_separator<char>(SEP)))
     {
         if (path.empty()) continue;
-        load_all_modules_in_path(fs::path(path) / suffix);
+        index_all_modules_in_path(fs::path(path) / suffix, index);
     }
 }
 
-static std::string my_get_env(const std::string &name, const std::string &defalt)
+/***********************************************************************
+ * The module cache:
+ * The index is saved along with the time stamps of every directory
+ * and manifest that it came from, so that the next process start
+ * skips the directory walks when none of the stamps have changed.
+ **********************************************************************/
+//! The cache file, or an empty path when the cache is disabled
+static fs::path get_module_cache_file(void)
 {
-    const char *env_var = std::getenv(name.c_str());
-    return (env_var != NULL)? env_var : defalt;
+    const char *cache_env = std::getenv("GRAS_MODULE_CACHE");
+    if (cache_env != NULL) return fs::path(cache_env);
+    const char *home_env = std::getenv("HOME");
+    if (home_env == NULL) home_env = std::getenv("APPDATA");
+    if (home_env == NULL) return fs::path();
+    return fs::path(home_env) / ".gras" / "module_cache";
 }
 
-//used by jit factory, but defined here for lazyness
-std::string get_gras_runtime_include_path(void)
+static bool module_cache_read(const fs::path &cache_file, const std::string &key, ModuleIndex &index)
 {
-    const std::string root = my_get_env("GRAS_ROOT", "@GRAS_ROOT@");
-    const fs::path inc_path = fs::path(root) / "include";
-    return inc_path.string();
+    std::ifstream cache_fstream(cache_file.string().c_str());
+    if (not cache_fstream.is_open()) return false;
+
+    std::string line;
+    if (not std::getline(cache_fstream, line) or line != key) return false;
+    while (std::getline(cache_fstream, line))
+    {
+        const size_t tab0 = line.find('\t');
+        if (tab0 == std::string::npos) return false;
+        const std::string kind = line.substr(0, tab0);
+        const size_t tab1 = line.find('\t', tab0+1);
+        const std::string arg0 = line.substr(tab0+1, tab1-tab0-1);
+        const std::string arg1 = (tab1 == std::string::npos)? "" : line.substr(tab1+1);
+        if (kind == "stamp")
+        {
+            long long t = 0;
+            std::istringstream(arg0) >> t;
+            if (get_time_stamp(arg1) != t) return false; //stale
+            index.stamps.push_back(std::make_pair(std::time_t(t), arg1));
+        }
+        else if (kind == "eager") index.eager_modules.push_back(arg0);
+        else if (kind == "lazy") index.lazy_modules[arg1] = arg0;
+        else return false;
+    }
+    return true;
+}
+
+static void module_cache_write(const fs::path &cache_file, const std::string &key, const ModuleIndex &index)
+{
+    //a change within the same second as the scan would not change the stamp,
+    //so only cache the index when everything is at least a second old
+    const std::time_t now = std::time(NULL);
+    for (size_t i = 0; i < index.stamps.size(); i++)
+    {
+        if (index.stamps[i].first >= now-1) return;
+    }
+
+    //write a unique temp file and rename it into place,
+    //so that concurrent processes never see a partial file
+    boost::system::error_code ec;
+    fs::create_directories(cache_file.parent_path(), ec);
+    const fs::path tmp_file = cache_file.parent_path() / fs::unique_path("%%%%-%%%%-%%%%.tmp");
+    {
+        std::ofstream tmp_fstream(tmp_file.string().c_str());
+        if (not tmp_fstream.is_open()) return; //not writable, just skip the cache
+        tmp_fstream << key << "\n";
+        for (size_t i = 0; i < index.stamps.size(); i++)
+        {
+            tmp_fstream << "stamp\t" << (long long)(index.stamps[i].first) << "\t" << index.stamps[i].second << "\n";
+        }
+        BOOST_FOREACH(const std::string &mod_path, index.eager_modules)
+        {
+            tmp_fstream << "eager\t" << mod_path << "\n";
+        }
+        for (std::map<std::string, std::string>::const_iterator it = index.lazy_modules.begin(); it != index.lazy_modules.end(); it++)
+        {
+            tmp_fstream << "lazy\t" << it->second << "\t" << it->first << "\n";
+        }
+    }
+    fs::rename(tmp_file, cache_file, ec);
+    if (ec) fs::remove(tmp_file, ec);
+}
+
+/***********************************************************************
+ * Loading modules
+ **********************************************************************/
+static std::string get_module_key(const std::string &mod_path)
+{
+    boost::system::error_code ec;
+    const fs::path canonical = fs::canonical(mod_path, ec);
+    return ec? mod_path : canonical.string();
+}
+
+/*!
+ * Load a module and record the factory paths that it registered.
+ * Loading a module that is already loaded registers nothing new,
+ * so the paths from its first load are kept rather than overwritten.
+ */
+static bool load_and_record_module(const std::string &mod_path)
+{
+    boost::recursive_mutex::scoped_lock l(loader_mutex);
+    std::vector<std::string> before = get_registered_factory_paths();
+    std::sort(before.begin(), before.end());
+
+    if (not load_module_in_path(mod_path.c_str())) return false;
+
+    //the module's paths are the ones that were not registered before
+    std::vector<std::string> paths;
+    BOOST_FOREACH(const std::string &p, get_registered_factory_paths())
+    {
+        if (not std::binary_search(before.begin(), before.end(), p)) paths.push_back(p);
+    }
+
+    std::vector<std::string> &recorded = get_loaded_modules()[get_module_key(mod_path)];
+    recorded.insert(recorded.end(), paths.begin(), paths.end());
+    return true;
+}
+
+//used by factory to load the module for a path on first make()
+bool load_module_for_factory_path(const std::string &path)
+{
+    //held across the erase and the load, so a concurrent make()
+    //for another path of the module waits until it is registered
+    boost::recursive_mutex::scoped_lock l(loader_mutex);
+    ModuleIndex &index = get_module_index();
+    if (index.lazy_modules.count(path) == 0) return false;
+    const std::string mod_path = index.lazy_modules[path];
+
+    //a module only loads once, so forget all of its paths
+    std::map<std::string, std::string>::iterator it = index.lazy_modules.begin();
+    while (it != index.lazy_modules.end())
+    {
+        if (it->second == mod_path) index.lazy_modules.erase(it++);
+        else it++;
+    }
+
+    if (not load_and_record_module(mod_path))
+    {
+        std::cerr << "GRAS Module loader fail: " << mod_path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::vector<std::string> gras::load_module(const std::string &path)
+{
+    boost::recursive_mutex::scoped_lock l(loader_mutex);
+
+    //the module may have already loaded from the search paths along with GRAS
+    if (not load_and_record_module(path))
+    {
+        throw std::runtime_error("GRAS Module loader fail: " + path + "\n" + module_load_error());
+    }
+    return get_loaded_modules()[get_module_key(path)];
 }
 
 GRAS_STATIC_BLOCK(gras_module_loader)
 {
-    //!search the GRAS_ROOT directory for this install
-    load_modules_from_paths(my_get_env("GRAS_ROOT", "@GRAS_ROOT@"), fs::path("") / "lib@LIB_SUFFIX@" / "gras" / "modules");
+    boost::recursive_mutex::scoped_lock l(loader_mutex);
+    ModuleIndex &index = get_module_index();
+
+    const std::string root_paths = my_get_env("GRAS_ROOT", "@GRAS_ROOT@");
+    const std::string search_paths = my_get_env("GRAS_PATH", "");
+    const std::string module_paths = my_get_env("GRAS_MODULE_PATH", "");
+
+    //the cache is only valid for the same search paths and index format
+    std::ostringstream key;
+    key << "gras " << get_gras_version() << "\tindex 2" << "\t" << root_paths << "\t" << search_paths << "\t" << module_paths;
+
+    const fs::path cache_file = get_module_cache_file();
+    if (cache_file.empty() or not module_cache_read(cache_file, key.str(), index))
+    {
+        index = ModuleIndex();
+
+        //!search the GRAS_ROOT directory for this install
+        index_modules_from_paths(root_paths, fs::path("") / "lib@LIB_SUFFIX@" / "gras" / "modules", index);
+
+        //!search the GRAS_PATH search directories for modules
+        index_modules_from_paths(search_paths, fs::path("") / "lib@LIB_SUFFIX@" / "gras" / "modules", index);
 
-    //!search the GRAS_PATH search directories for modules
-    load_modules_from_paths(my_get_env("GRAS_PATH", ""), fs::path("") / "lib@LIB_SUFFIX@" / "gras" / "modules");
+        //!search the explicit module paths
+        index_modules_from_paths(module_paths, fs::path(""), index);
 
-    //!search the explicit module paths
-    load_modules_from_paths(my_get_env("GRAS_MODULE_PATH", ""), fs::path(""));
+        if (not cache_file.empty()) module_cache_write(cache_file, key.str(), index);
+    }
+
+    //modules without a manifest cannot load on demand
+    BOOST_FOREACH(const std::string &mod_path, index.eager_modules)
+    {
+        if (not load_and_record_module(mod_path))
+        {
+            std::cerr << "GRAS Module loader fail: " << mod_path << std::endl;
+        }
+    }
 }
@@ -10,6 +10,8 @@ void BlockActor::handle_output_buffer(const OutputBufferMessage &message, const
 {
     TimerAccumulate ta(data->stats.total_time_output);
     MESSAGE_TRACER();
+    this->update_stats(ta.start);
+    trace_instant("buffer_return", this);
     const size_t index = message.index;
 
     //a buffer has returned from the downstream
@@ -25,6 +27,7 @@ void BlockActor::handle_output_token(const OutputTokenMessage &message, const Th
 {
     TimerAccumulate ta(data->stats.total_time_output);
     MESSAGE_TRACER();
+    this->update_stats(ta.start);
     ASSERT(message.index < worker->get_num_outputs());
 
     //store the token of the downstream consumer
@@ -35,6 +38,8 @@ void BlockActor::handle_output_check(const OutputCheckMessage &message, const Th
 {
     TimerAccumulate ta(data->stats.total_time_output);
     MESSAGE_TRACER();
+    this->update_stats(ta.start);
+    trace_instant("output_check", this);
     const size_t index = message.index;
 
     //a downstream block has declared itself done, recheck the token
@@ -49,6 +54,8 @@ void BlockActor::handle_output_hint(const OutputHintMessage &message, const Ther
 {
     TimerAccumulate ta(data->stats.total_time_output);
     MESSAGE_TRACER();
+    this->update_stats(ta.start);
+    trace_instant("output_hint", this);
     const size_t index = message.index;
 
     //update the buffer allocation hint
@@ -68,12 +75,57 @@ void BlockActor::handle_output_hint(const OutputHintMessage &message, const Ther
     hints.push_back(message);
 
     data->output_allocation_hints[index] = hints;
+
+    //merge the tag subscriptions of all downstream consumers
+    TagSubscription tag_subscription;
+    tag_subscription.all = false;
+    BOOST_FOREACH(const OutputHintMessage &hint, hints)
+    {
+        tag_subscription.merge(hint.tag_subscription);
+    }
+
+    //a changed subscription passes through to the upstream
+    if (tag_subscription == data->output_tag_subscriptions[index]) return;
+    data->output_tag_subscriptions[index] = tag_subscription;
+    for (size_t i = 0; i < worker->get_num_inputs(); i++)
+    {
+        this->post_input_hint(i);
+    }
+}
+
+void BlockActor::handle_output_pressure(const OutputPressureMessage &message, const Theron::Address)
+{
+    TimerAccumulate ta(data->stats.total_time_output);
+    MESSAGE_TRACER();
+    this->update_stats(ta.start);
+    trace_instant("output_pressure", this);
+    const size_t index = message.index;
+
+    //track the downstream msg ports that are full:
+    //remove any old entries with expired token
+    //remove any older entries with matching token
+    std::vector<WeakToken> full_ports;
+    BOOST_FOREACH(const WeakToken &token, data->output_msg_pressure[index])
+    {
+        if (token.expired()) continue;
+        if (token.lock() == message.token.lock()) continue;
+        full_ports.push_back(token);
+    }
+    if (message.full) full_ports.push_back(message.token);
+    data->output_msg_pressure[index] = full_ports;
+
+    //this output is not ready while any downstream is full
+    data->outputs_backpressure.set(index, not full_ports.empty());
+
+    ta.done();
+    this->task_main();
 }
 
 void BlockActor::handle_output_alloc(const OutputAllocMessage &message, const Theron::Address)
 {
     TimerAccumulate ta(data->stats.total_time_output);
     MESSAGE_TRACER();
+    this->update_stats(ta.start);
     const size_t index = message.index;
 
     //return of a positive downstream allocation
@@ -84,6 +136,7 @@ void BlockActor::handle_output_update(const OutputUpdateMessage &message, const
 {
     TimerAccumulate ta(data->stats.total_time_output);
     MESSAGE_TRACER();
+    this->update_stats(ta.start);
     const size_t i = message.index;
 
     //update buffer queue configuration
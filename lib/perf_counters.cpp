@@ -0,0 +1,103 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#include <gras_impl/perf_counters.hpp>
+
+using namespace gras;
+
+#ifdef __linux__
+
+#include <boost/thread/tss.hpp>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <cstring>
+
+/***********************************************************************
+ * The counters of a thread are opened as a group,
+ * so that one read returns all of the counters at once,
+ * and the kernel schedules the counters together.
+ * A thread that fails to open its counters does not try again;
+ * this is the case when perf_event_paranoid forbids the counters.
+ **********************************************************************/
+struct PerfCounterGroup
+{
+    enum {NUM_COUNTERS = 4};
+
+    PerfCounterGroup(void)
+    {
+        static const unsigned long long configs[NUM_COUNTERS] = {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_BRANCH_MISSES,
+        };
+        for (size_t i = 0; i < NUM_COUNTERS; i++) fds[i] = -1;
+        for (size_t i = 0; i < NUM_COUNTERS; i++)
+        {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[i];
+            attr.read_format = PERF_FORMAT_GROUP;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.disabled = (i == 0)? 1 : 0;
+            fds[i] = int(syscall(__NR_perf_event_open, &attr, 0/*this thread*/, -1/*any cpu*/, fds[0], 0));
+            if (fds[i] < 0)
+            {
+                this->close_all();
+                return;
+            }
+        }
+        ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    ~PerfCounterGroup(void)
+    {
+        this->close_all();
+    }
+
+    bool ok(void) const
+    {
+        return fds[0] >= 0;
+    }
+
+    void close_all(void)
+    {
+        for (size_t i = 0; i < NUM_COUNTERS; i++)
+        {
+            if (fds[i] >= 0) close(fds[i]);
+            fds[i] = -1;
+        }
+    }
+
+    int fds[NUM_COUNTERS];
+};
+
+bool gras::perf_counters_read(PerfCounterValues &values)
+{
+    static boost::thread_specific_ptr<PerfCounterGroup> thread_group;
+    if GRAS_UNLIKELY(thread_group.get() == NULL) thread_group.reset(new PerfCounterGroup());
+    const PerfCounterGroup &group = *thread_group;
+    if GRAS_UNLIKELY(not group.ok()) return false;
+
+    //group format: the number of counters, then each value
+    unsigned long long buff[1 + PerfCounterGroup::NUM_COUNTERS];
+    if GRAS_UNLIKELY(read(group.fds[0], buff, sizeof(buff)) != ssize_t(sizeof(buff))) return false;
+    values.cycles = buff[1];
+    values.instructions = buff[2];
+    values.cache_misses = buff[3];
+    values.branch_misses = buff[4];
+    return true;
+}
+
+#else //__linux__
+
+bool gras::perf_counters_read(PerfCounterValues &)
+{
+    return false;
+}
+
+#endif //__linux__
@@ -2,6 +2,7 @@
 
 #include "gras_impl/query_common.hpp"
 #include "gras_impl/debug.hpp"
+#include "gras_impl/json_writer.hpp"
 #include <PMC/PMC.hpp>
 #include <PMC/Containers.hpp>
 #include <boost/property_tree/ptree.hpp>
@@ -9,7 +10,10 @@
 #include <boost/cstdint.hpp>
 #include <vector>
 #include <complex>
+#include <limits>
+#include <sstream>
 
+using namespace gras;
 using namespace boost::property_tree;
 
 PMCC gras::ptree_to_pmc(const ptree &value)
@@ -56,57 +60,87 @@ PMCC gras::ptree_to_pmc(const ptree &value)
     return PMC();
 }
 
-ptree gras::pmc_to_ptree(const PMCC &value)
+template <typename T>
+static std::string complex_to_string(const std::complex<T> &c)
 {
-    ptree v;
-    #define pmc_to_ptree_try(type) \
-    if (value.is<type >()) {v.put_value(value.as<type >()); return v;}
+    std::ostringstream ss;
+    ss.precision(std::numeric_limits<T>::digits10 + 1);
+    ss << c;
+    return ss.str();
+}
+
+static void json_value(JsonWriter &json, const char v)
+{
+    json.value(std::string(1, v));
+}
+
+template <typename T>
+static void json_value(JsonWriter &json, const T &v)
+{
+    json.value(v);
+}
+
+static void json_value(JsonWriter &json, const signed char v){json.value(int(v));}
+static void json_value(JsonWriter &json, const unsigned char v){json.value(unsigned(v));}
+static void json_value(JsonWriter &json, const signed short v){json.value(int(v));}
+static void json_value(JsonWriter &json, const unsigned short v){json.value(unsigned(v));}
+static void json_value(JsonWriter &json, const float v){json.value(double(v));}
+static void json_value(JsonWriter &json, const std::complex<float> &v){json.value(complex_to_string(v));}
+static void json_value(JsonWriter &json, const std::complex<double> &v){json.value(complex_to_string(v));}
+
+void gras::pmc_to_json(JsonWriter &json, const PMCC &value)
+{
+    #define pmc_to_json_try(type) \
+    if (value.is<type >()) {json_value(json, value.as<type >()); return;}
 
     //determine number
-    pmc_to_ptree_try(char);
-    pmc_to_ptree_try(signed char);
-    pmc_to_ptree_try(unsigned char);
-    pmc_to_ptree_try(signed short);
-    pmc_to_ptree_try(unsigned short);
-    pmc_to_ptree_try(signed int);
-    pmc_to_ptree_try(unsigned int);
-    pmc_to_ptree_try(signed long);
-    pmc_to_ptree_try(unsigned long);
-    pmc_to_ptree_try(signed long long);
-    pmc_to_ptree_try(unsigned long long);
-    pmc_to_ptree_try(float);
-    pmc_to_ptree_try(double);
-    pmc_to_ptree_try(std::complex<float>);
-    pmc_to_ptree_try(std::complex<double>);
+    pmc_to_json_try(char);
+    pmc_to_json_try(signed char);
+    pmc_to_json_try(unsigned char);
+    pmc_to_json_try(signed short);
+    pmc_to_json_try(unsigned short);
+    pmc_to_json_try(signed int);
+    pmc_to_json_try(unsigned int);
+    pmc_to_json_try(signed long);
+    pmc_to_json_try(unsigned long);
+    pmc_to_json_try(signed long long);
+    pmc_to_json_try(unsigned long long);
+    pmc_to_json_try(float);
+    pmc_to_json_try(double);
+    pmc_to_json_try(std::complex<float>);
+    pmc_to_json_try(std::complex<double>);
 
     //determine string
-    pmc_to_ptree_try(std::string);
+    pmc_to_json_try(std::string);
 
     //try numeric vector
-    #define pmc_to_ptree_tryv(type) \
+    #define pmc_to_json_tryv(type) \
     if (value.is<std::vector<type> >()) \
     { \
+        json.begin_array(); \
         BOOST_FOREACH(const type &elem, value.as<std::vector<type> >()) \
         { \
-            ptree t; t.put_value(elem); \
-            v.push_back(std::make_pair("", t)); \
+            json_value(json, elem); \
         } \
+        json.end_array(); \
+        return; \
     }
-    pmc_to_ptree_tryv(char);
-    pmc_to_ptree_tryv(signed char);
-    pmc_to_ptree_tryv(unsigned char);
-    pmc_to_ptree_tryv(signed short);
-    pmc_to_ptree_tryv(unsigned short);
-    pmc_to_ptree_tryv(signed int);
-    pmc_to_ptree_tryv(unsigned int);
-    pmc_to_ptree_tryv(signed long);
-    pmc_to_ptree_tryv(unsigned long);
-    pmc_to_ptree_tryv(signed long long);
-    pmc_to_ptree_tryv(unsigned long long);
-    pmc_to_ptree_tryv(float);
-    pmc_to_ptree_tryv(double);
-    pmc_to_ptree_tryv(std::complex<float>);
-    pmc_to_ptree_tryv(std::complex<double>);
-
-    return v;
+    pmc_to_json_tryv(char);
+    pmc_to_json_tryv(signed char);
+    pmc_to_json_tryv(unsigned char);
+    pmc_to_json_tryv(signed short);
+    pmc_to_json_tryv(unsigned short);
+    pmc_to_json_tryv(signed int);
+    pmc_to_json_tryv(unsigned int);
+    pmc_to_json_tryv(signed long);
+    pmc_to_json_tryv(unsigned long);
+    pmc_to_json_tryv(signed long long);
+    pmc_to_json_tryv(unsigned long long);
+    pmc_to_json_tryv(float);
+    pmc_to_json_tryv(double);
+    pmc_to_json_tryv(std::complex<float>);
+    pmc_to_json_tryv(std::complex<double>);
+
+    //unknown types have no value
+    json.null_value();
 }
@@ -0,0 +1,453 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#include "element_impl.hpp"
+#include <gras_impl/query_server.hpp>
+#include <gras_impl/json_writer.hpp>
+#include <gras_impl/query_common.hpp>
+#include <gras/chrono.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/foreach.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <map>
+
+#ifdef _MSC_VER
+#define popen _popen
+#define pclose _pclose
+#endif
+
+using namespace gras;
+using boost::asio::ip::tcp;
+
+static void null_deleter(ElementImpl *){}
+
+/***********************************************************************
+ * Helpers for parsing requests and writing responses
+ **********************************************************************/
+static std::string url_decode(const std::string &s)
+{
+    std::string out;
+    for (size_t i = 0; i < s.size(); i++)
+    {
+        if (s[i] == '+') out += ' ';
+        else if (s[i] == '%' and i+2 < s.size())
+        {
+            out += char(std::strtol(s.substr(i+1, 2).c_str(), NULL, 16));
+            i += 2;
+        }
+        else out += s[i];
+    }
+    return out;
+}
+
+//! Convert the url query string into json args for TopBlock::query
+static std::string query_string_to_json(const std::string &path, const std::string &query_string, const time_ticks_t since = 0)
+{
+    //the block ids and call args are always lists
+    std::map<std::string, std::vector<std::string> > lists;
+    std::map<std::string, std::string> values;
+    std::istringstream ss(query_string);
+    std::string pair;
+    while (std::getline(ss, pair, '&'))
+    {
+        const size_t eq = pair.find('=');
+        if (eq == std::string::npos) continue;
+        const std::string key = url_decode(pair.substr(0, eq));
+        const std::string value = url_decode(pair.substr(eq+1));
+        if (key == "blocks" or key == "args") lists[key].push_back(value);
+        else values[key] = value;
+    }
+
+    JsonWriter json;
+    json.begin_object();
+    json.field("path", path);
+    for (std::map<std::string, std::vector<std::string> >::const_iterator it = lists.begin(); it != lists.end(); it++)
+    {
+        json.field(it->first.c_str(), it->second);
+    }
+    for (std::map<std::string, std::string>::const_iterator it = values.begin(); it != values.end(); it++)
+    {
+        if (it->first == "path" or it->first == "since") continue;
+        json.field(it->first.c_str(), it->second);
+    }
+    if (since != 0) json.field("since", since);
+    json.end_object();
+    return json.str();
+}
+
+/*!
+ * The latest stats time of the blocks in a stats result.
+ * The next delta starts there rather than at the wall clock,
+ * so a snapshot that is published while a query runs is not skipped.
+ */
+static time_ticks_t get_latest_stats_time(const std::string &result)
+{
+    time_ticks_t latest = 0;
+    const boost::property_tree::ptree tree = json_to_ptree(result);
+    BOOST_FOREACH(const boost::property_tree::ptree::value_type &block, tree.get_child("blocks"))
+    {
+        latest = std::max(latest, block.second.get<time_ticks_t>("stats_time"));
+    }
+    return latest;
+}
+
+static bool ends_with(const std::string &s, const std::string &suffix)
+{
+    return s.size() >= suffix.size() and s.compare(s.size()-suffix.size(), suffix.size(), suffix) == 0;
+}
+
+static const char *content_type(const std::string &path)
+{
+    if (ends_with(path, ".html")) return "text/html";
+    if (ends_with(path, ".js")) return "text/javascript";
+    if (ends_with(path, ".css")) return "text/css";
+    if (ends_with(path, ".json")) return "application/json";
+    if (ends_with(path, ".png")) return "image/png";
+    return "text/plain";
+}
+
+static void write_response(tcp::socket &socket, const char *status, const char *type, const std::string &body)
+{
+    std::ostringstream header;
+    header << "HTTP/1.1 " << status << "\r\n"
+           << "Content-Type: " << type << "\r\n"
+           << "Content-Length: " << body.size() << "\r\n"
+           << "Connection: close\r\n\r\n";
+    boost::system::error_code ec;
+    boost::asio::write(socket, boost::asio::buffer(header.str()), ec);
+    if (not ec) boost::asio::write(socket, boost::asio::buffer(body), ec);
+}
+
+//! Render dot markup into a png with the graphviz dot executable
+static std::string render_dot_png(const std::string &markup)
+{
+    const boost::filesystem::path dot_path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("gras-%%%%-%%%%-%%%%.dot");
+    {
+        std::ofstream dot_file(dot_path.string().c_str());
+        dot_file << markup;
+    }
+    const char *dot_exe = std::getenv("DOT_EXECUTABLE");
+    const std::string command = std::string("\"") + ((dot_exe == NULL)? "dot" : dot_exe) + "\" -Tpng \"" + dot_path.string() + "\"";
+
+    std::string png;
+    FILE *p = popen(command.c_str(), "r");
+    if (p != NULL)
+    {
+        char buff[4096];
+        size_t n;
+        while ((n = std::fread(buff, 1, sizeof(buff), p)) > 0) png.append(buff, n);
+        pclose(p);
+    }
+    boost::system::error_code ec;
+    boost::filesystem::remove(dot_path, ec);
+    return png;
+}
+
+/***********************************************************************
+ * Server lifetime
+ **********************************************************************/
+//! Counts a connection until its socket is destroyed, the server waits on the count
+struct QueryServer::ConnectionCount
+{
+    ConnectionCount(QueryServer *server):
+        server(server)
+    {
+        boost::mutex::scoped_lock lock(server->_mutex);
+        server->_num_connections++;
+    }
+
+    ~ConnectionCount(void)
+    {
+        boost::mutex::scoped_lock lock(server->_mutex);
+        server->_num_connections--;
+        server->_cond.notify_all();
+    }
+
+    QueryServer *server;
+};
+
+struct QueryServer::Connection
+{
+    Connection(QueryServer *server):
+        count(server),
+        socket(server->_io_service),
+        timer(server->_io_service),
+        request(8192),
+        reading(true)
+    {}
+
+    ConnectionCount count; //first member, so the last one destroyed
+    tcp::socket socket;
+    boost::asio::deadline_timer timer;
+    boost::asio::streambuf request;
+    bool reading;
+};
+
+QueryServer::QueryServer(ElementImpl *self, const unsigned short port, const std::string &assets_dir, const std::string &bind_address):
+    _assets_dir(assets_dir),
+    _running(true),
+    _num_connections(0)
+{
+    _top_block.reset(self, &null_deleter);
+    this->bind_acceptors(bind_address, port);
+    BOOST_FOREACH(const AcceptorSptr &acceptor, _acceptors) this->accept_loop(acceptor);
+    _io_thread = boost::thread(boost::bind(&boost::asio::io_service::run, &_io_service));
+}
+
+QueryServer::~QueryServer(void)
+{
+    //stop accepting and reading requests on the io thread,
+    //which returns once all of the pending handlers are done
+    _io_service.post(boost::bind(&QueryServer::handle_shutdown, this));
+    _io_thread.join();
+
+    //wake up the connection threads and wait for them to finish
+    boost::mutex::scoped_lock lock(_mutex);
+    _running = false;
+    _cond.notify_all();
+    for (std::set<tcp::socket *>::iterator it = _sockets.begin(); it != _sockets.end(); it++)
+    {
+        boost::system::error_code ec;
+        (*it)->shutdown(tcp::socket::shutdown_both, ec);
+    }
+    while (_num_connections != 0) _cond.wait(lock);
+}
+
+void QueryServer::bind_acceptors(const std::string &bind_address, const unsigned short port)
+{
+    //an empty address listens on all interfaces
+    std::vector<tcp::endpoint> endpoints;
+    if (bind_address.empty()) endpoints.push_back(tcp::endpoint(tcp::v4(), port));
+    else
+    {
+        tcp::resolver resolver(_io_service);
+        const tcp::resolver::query query(bind_address, boost::lexical_cast<std::string>(port),
+            tcp::resolver::query::passive | tcp::resolver::query::numeric_service);
+        tcp::resolver::iterator it = resolver.resolve(query); //throws when the address does not resolve
+        for (; it != tcp::resolver::iterator(); it++)
+        {
+            if (std::find(endpoints.begin(), endpoints.end(), it->endpoint()) == endpoints.end()) endpoints.push_back(it->endpoint());
+        }
+    }
+
+    //listen on every address of the name, like both 127.0.0.1 and ::1 for localhost,
+    //all on the port of the first one, an address that fails is skipped (like ipv6 on a host without it)
+    boost::system::error_code first_ec;
+    BOOST_FOREACH(tcp::endpoint endpoint, endpoints)
+    {
+        if (not _acceptors.empty()) endpoint.port(this->port());
+        AcceptorSptr acceptor(new tcp::acceptor(_io_service));
+        boost::system::error_code ec;
+        acceptor->open(endpoint.protocol(), ec);
+        if (not ec and endpoint.address().is_v6()) acceptor->set_option(boost::asio::ip::v6_only(true), ec);
+        if (not ec) acceptor->set_option(tcp::acceptor::reuse_address(true), ec);
+        if (not ec) acceptor->bind(endpoint, ec);
+        if (not ec) acceptor->listen(boost::asio::socket_base::max_connections, ec);
+        if (ec)
+        {
+            if (not first_ec) first_ec = ec;
+            continue;
+        }
+        _acceptors.push_back(acceptor);
+    }
+    if (_acceptors.empty()) throw boost::system::system_error(first_ec);
+}
+
+unsigned short QueryServer::port(void) const
+{
+    return _acceptors.front()->local_endpoint().port();
+}
+
+bool QueryServer::sleep_while_running(const double seconds)
+{
+    boost::mutex::scoped_lock lock(_mutex);
+    const boost::system_time deadline = boost::get_system_time() + boost::posix_time::microseconds(long(seconds*1e6));
+    while (_running)
+    {
+        if (not _cond.timed_wait(lock, deadline)) break;
+    }
+    return _running;
+}
+
+/***********************************************************************
+ * Accepting connections and reading requests on the io thread
+ **********************************************************************/
+void QueryServer::accept_loop(AcceptorSptr acceptor)
+{
+    ConnectionSptr conn(new Connection(this));
+    acceptor->async_accept(conn->socket, boost::bind(&QueryServer::handle_accept, this, acceptor, conn, boost::asio::placeholders::error));
+}
+
+void QueryServer::handle_accept(AcceptorSptr acceptor, ConnectionSptr conn, const boost::system::error_code &ec)
+{
+    if (ec == boost::asio::error::operation_aborted) return; //the acceptor was closed
+    this->accept_loop(acceptor);
+    if (ec) return;
+
+    //read the request head without a thread, so an idle client only costs a socket,
+    //and a client that does not send the request in time is closed
+    _pending.insert(conn.get());
+    conn->timer.expires_from_now(boost::posix_time::milliseconds(long(REQUEST_TIMEOUT_MS)));
+    conn->timer.async_wait(boost::bind(&QueryServer::handle_timeout, this, conn, boost::asio::placeholders::error));
+    boost::asio::async_read_until(conn->socket, conn->request, "\r\n\r\n", boost::bind(&QueryServer::handle_read, this, conn, boost::asio::placeholders::error));
+}
+
+void QueryServer::handle_timeout(ConnectionSptr conn, const boost::system::error_code &ec)
+{
+    //the pending read then completes with an error
+    if (ec or not conn->reading) return;
+    boost::system::error_code close_ec;
+    conn->socket.close(close_ec);
+}
+
+void QueryServer::handle_read(ConnectionSptr conn, const boost::system::error_code &ec)
+{
+    _pending.erase(conn.get());
+    conn->reading = false;
+    boost::system::error_code cancel_ec;
+    conn->timer.cancel(cancel_ec);
+    if (ec) return; //timed out, closed, or the head was too large
+
+    //each request is handled in its own thread, up to a limit
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        if (_sockets.size() < MAX_CONNECTIONS)
+        {
+            _sockets.insert(&conn->socket);
+            boost::thread(boost::bind(&QueryServer::handle_connection, this, conn)).detach();
+            return;
+        }
+    }
+    write_response(conn->socket, "503 Service Unavailable", "text/plain", "too many connections");
+}
+
+void QueryServer::handle_shutdown(void)
+{
+    //the pending accepts and reads complete with an error and free their connections
+    boost::system::error_code ec;
+    BOOST_FOREACH(const AcceptorSptr &acceptor, _acceptors) acceptor->close(ec);
+    BOOST_FOREACH(Connection *conn, _pending)
+    {
+        conn->timer.cancel(ec);
+        conn->socket.close(ec);
+    }
+}
+
+/***********************************************************************
+ * Connection handling
+ **********************************************************************/
+void QueryServer::handle_connection(ConnectionSptr conn)
+{
+    try
+    {
+        //parse the request line
+        std::istream is(&conn->request);
+        std::string method, target;
+        is >> method >> target;
+
+        const size_t q = target.find('?');
+        const std::string path = url_decode(target.substr(0, q));
+        const std::string query_string = (q == std::string::npos)? "" : target.substr(q+1);
+
+        if (method != "GET") write_response(conn->socket, "405 Method Not Allowed", "text/plain", "only GET is supported");
+        else if (path == "/stats.events") this->handle_events(conn->socket, query_string);
+        else this->handle_request(conn->socket, path, query_string);
+    }
+    catch (const std::exception &)
+    {
+        //the client went away or sent a bad request
+    }
+
+    //the connection is freed when the last reference is released,
+    //which the server waits for before it is destroyed
+    boost::mutex::scoped_lock lock(_mutex);
+    boost::system::error_code ec;
+    conn->socket.shutdown(tcp::socket::shutdown_both, ec);
+    _sockets.erase(&conn->socket);
+}
+
+void QueryServer::handle_request(tcp::socket &socket, const std::string &path, const std::string &query_string)
+{
+    //the arguments that the top block was served with
+    if (path == "/args.json")
+    {
+        JsonWriter json;
+        json.begin_object();
+        json.field("name", _top_block->name);
+        json.end_object();
+        return write_response(socket, "200 OK", "application/json", json.str());
+    }
+
+    //the topology rendered by graphviz
+    if (ends_with(path, ".dot.png"))
+    {
+        const std::string dot_path = path.substr(0, path.size()-4);
+        const std::string markup = _top_block.query(query_string_to_json(dot_path, query_string));
+        return write_response(socket, "200 OK", "image/png", render_dot_png(markup));
+    }
+
+    //query paths go to the top block
+    if (ends_with(path, ".json") or ends_with(path, ".dot") or path == "/metrics")
+    {
+        std::string result;
+        try
+        {
+            result = _top_block.query(query_string_to_json(path, query_string));
+        }
+        catch (const std::exception &ex)
+        {
+            return write_response(socket, "400 Bad Request", "text/plain", ex.what());
+        }
+        if (path == "/metrics") return write_response(socket, "200 OK", "application/openmetrics-text; version=1.0.0; charset=utf-8", result);
+        return write_response(socket, "200 OK", content_type(path), result);
+    }
+
+    //static assets, never outside of the assets directory
+    const std::string file_path = (path == "/")? "/main.html" : path;
+    std::ifstream file;
+    if (not _assets_dir.empty() and file_path.find("..") == std::string::npos)
+    {
+        file.open((_assets_dir + file_path).c_str(), std::ios::in | std::ios::binary);
+    }
+    if (not file.is_open()) return write_response(socket, "404 Not Found", "text/html", "<p>not found</p>");
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    write_response(socket, "200 OK", content_type(file_path), contents.str());
+}
+
+void QueryServer::handle_events(tcp::socket &socket, const std::string &query_string)
+{
+    //the update rate in events per second
+    double rate = 3.0;
+    std::istringstream ss(query_string);
+    std::string pair;
+    while (std::getline(ss, pair, '&'))
+    {
+        if (pair.compare(0, 5, "rate=") == 0) rate = std::atof(pair.c_str() + 5);
+    }
+    rate = std::max(0.1, std::min(rate, 100.0));
+
+    const std::string header =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/event-stream\r\n"
+        "Cache-Control: no-cache\r\n"
+        "Connection: close\r\n\r\n";
+    boost::asio::write(socket, boost::asio::buffer(header));
+
+    //the first event has the stats of all requested blocks,
+    //later events only the blocks that published since the last one
+    time_ticks_t since = 0;
+    do
+    {
+        const std::string result = _top_block.query(query_string_to_json("/stats.json", query_string, since));
+        since = std::max(since, get_latest_stats_time(result));
+        const std::string event = "data: " + result + "\n\n";
+        boost::asio::write(socket, boost::asio::buffer(event));
+    }
+    while (this->sleep_while_running(1.0/rate));
+}
@@ -2,14 +2,13 @@
 
 #include <gras/top_block.hpp>
 #include <gras_impl/messages.hpp>
-#include <gras_impl/interruptible_thread.hpp>
 
 THERON_DEFINE_REGISTERED_MESSAGE(gras::TopAllocMessage);
 THERON_DEFINE_REGISTERED_MESSAGE(gras::TopActiveMessage);
 THERON_DEFINE_REGISTERED_MESSAGE(gras::TopInertMessage);
 THERON_DEFINE_REGISTERED_MESSAGE(gras::TopTokenMessage);
 THERON_DEFINE_REGISTERED_MESSAGE(gras::TopConfigMessage);
-THERON_DEFINE_REGISTERED_MESSAGE(gras::TopThreadMessage);
+THERON_DEFINE_REGISTERED_MESSAGE(gras::TopCancelMessage);
 
 THERON_DEFINE_REGISTERED_MESSAGE(gras::InputTagMessage);
 THERON_DEFINE_REGISTERED_MESSAGE(gras::InputMsgMessage);
@@ -23,9 +22,9 @@ THERON_DEFINE_REGISTERED_MESSAGE(gras::OutputBufferMessage);
 THERON_DEFINE_REGISTERED_MESSAGE(gras::OutputTokenMessage);
 THERON_DEFINE_REGISTERED_MESSAGE(gras::OutputCheckMessage);
 THERON_DEFINE_REGISTERED_MESSAGE(gras::OutputHintMessage);
+THERON_DEFINE_REGISTERED_MESSAGE(gras::OutputPressureMessage);
 THERON_DEFINE_REGISTERED_MESSAGE(gras::OutputAllocMessage);
 THERON_DEFINE_REGISTERED_MESSAGE(gras::OutputUpdateMessage);
 
 THERON_DEFINE_REGISTERED_MESSAGE(gras::CallableMessage);
 THERON_DEFINE_REGISTERED_MESSAGE(gras::SelfKickMessage);
-THERON_DEFINE_REGISTERED_MESSAGE(gras::GetStatsMessage);
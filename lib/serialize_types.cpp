@@ -92,6 +92,7 @@ void serialize(Archive &ar, gras::StreamTag &t, const unsigned int)
     ar & t.key;
     ar & t.val;
     ar & t.src;
+    if (Archive::is_loading::value) t = gras::StreamTag(t.key, t.val, t.src); //intern the key
 }
 }}
 
@@ -1,9 +1,120 @@
 // Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
 
 #include <gras/tags.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+#include <vector>
+#include <map>
 
 using namespace gras;
 
+/***********************************************************************
+ * Tag key symbol table
+ **********************************************************************/
+struct TagKeyTable
+{
+    TagKeyTable(void)
+    {
+        keys.push_back(PMCC()); //null key is id 0
+    }
+
+    //string keys are the common case, use a lookup
+    std::map<std::string, size_t> strings;
+
+    //all keys indexed by id
+    std::vector<PMCC> keys;
+};
+
+static TagKeyTable &get_tag_key_table(void)
+{
+    static TagKeyTable t;
+    return t;
+}
+
+static boost::mutex tag_key_mutex;
+
+static size_t intern_string_key(const std::string &key, const PMCC &obj)
+{
+    TagKeyTable &t = get_tag_key_table();
+    std::map<std::string, size_t>::const_iterator it = t.strings.find(key);
+    if (it != t.strings.end()) return it->second;
+    const size_t id = t.keys.size();
+    t.keys.push_back(obj? obj : PMC_M(key));
+    t.strings[key] = id;
+    return id;
+}
+
+/*!
+ * Ids never change once interned, so each thread caches the string keys
+ * that it has seen, and only takes the table lock the first time.
+ * This keeps the lock off of the work() path of blocks making tags.
+ */
+typedef std::map<std::string, size_t> TagKeyCache;
+
+static size_t lookup_string_key(const std::string &key, const PMCC &obj)
+{
+    static boost::thread_specific_ptr<TagKeyCache> thread_cache;
+    if GRAS_UNLIKELY(thread_cache.get() == NULL) thread_cache.reset(new TagKeyCache());
+    TagKeyCache &cache = *thread_cache;
+    TagKeyCache::const_iterator it = cache.find(key);
+    if GRAS_LIKELY(it != cache.end()) return it->second;
+
+    size_t id = 0;
+    {
+        boost::mutex::scoped_lock l(tag_key_mutex);
+        id = intern_string_key(key, obj);
+    }
+    cache[key] = id;
+    return id;
+}
+
+TagKey::TagKey(void):
+    id(0)
+{
+    //NOP
+}
+
+TagKey::TagKey(const PMCC &key):
+    id(0)
+{
+    if (not key) return;
+    if (key.is<std::string>())
+    {
+        id = lookup_string_key(key.as<std::string>(), key);
+        return;
+    }
+
+    //other key types are rare, search by equality
+    boost::mutex::scoped_lock l(tag_key_mutex);
+    TagKeyTable &t = get_tag_key_table();
+    for (size_t i = 1; i < t.keys.size(); i++)
+    {
+        if (t.keys[i].eq(key)) {id = i; return;}
+    }
+    id = t.keys.size();
+    t.keys.push_back(key);
+}
+
+TagKey::TagKey(const std::string &key)
+{
+    id = lookup_string_key(key, PMCC());
+}
+
+TagKey::TagKey(const char *key)
+{
+    id = lookup_string_key(key, PMCC());
+}
+
+PMCC TagKey::key(void) const
+{
+    boost::mutex::scoped_lock l(tag_key_mutex);
+    return get_tag_key_table().keys.at(id);
+}
+
+/***********************************************************************
+ * Tag types
+ **********************************************************************/
+
 Tag::Tag(const item_index_t &offset, const PMCC &object):
     offset(offset), object(object)
 {
@@ -23,7 +134,7 @@ bool gras::operator==(const Tag &lhs, const Tag &rhs)
 }
 
 StreamTag::StreamTag(const PMCC &key, const PMCC &val, const PMCC &src):
-    key(key), val(val), src(src)
+    key(key), val(val), src(src), _interned_key(key), _key_id(key)
 {
     //NOP
 }
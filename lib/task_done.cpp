@@ -13,6 +13,7 @@ void Block::mark_done(void)
 void BlockActor::mark_done(void)
 {
     if (data->block_state == BLOCK_STATE_DONE) return; //can re-enter checking done first
+    TaskScope task_scope(data.get()); //the leftover tags are flushed below
 
     data->stats.stop_time = time_now();
     data->block->notify_inactive();
@@ -20,19 +21,25 @@ void BlockActor::mark_done(void)
     //flush partial output buffers to the downstream
     for (size_t i = 0; i < worker->get_num_outputs(); i++)
     {
-        if (not data->output_queues.ready(i)) continue;
-        SBuffer &buff = data->output_queues.front(i);
-        if (buff.length == 0) continue;
-        InputBufferMessage buff_msg;
-        buff_msg.buffer = buff;
-        worker->post_downstream(i, buff_msg);
-        data->output_queues.pop(i);
+        if (data->output_queues.ready(i) and data->output_queues.front(i).length != 0)
+        {
+            InputBufferMessage buff_msg;
+            buff_msg.buffer = data->output_queues.front(i);
+            if (data->latency_tracking)
+            {
+                buff_msg.produce_time = data->stats.stop_time;
+                buff_msg.origin_time = data->work_origin_time? data->work_origin_time : data->stats.stop_time;
+            }
+            this->take_output_tags(i, buff_msg.tags);
+            worker->post_downstream(i, buff_msg);
+            data->output_queues.pop(i);
+        }
+        this->post_output_tags(i); //any leftovers
     }
 
-    data->interruptible_thread.reset();
-
     //mark down the new state
     data->block_state = BLOCK_STATE_DONE;
+    trace_instant("state_done", this);
 
     //release upstream, downstream, and executor tokens
     data->token_pool.clear();
@@ -46,9 +53,18 @@ void BlockActor::mark_done(void)
     {
         data->input_msgs[i].clear();
         data->input_tags[i].clear();
+        data->input_latency_stamps[i].clear();
         data->num_input_items_read[i] = 0;
         data->num_input_msgs_read[i] = 0;
+        this->update_msg_pressure(i); //release the upstream
+    }
+
+    //forget about full downstream msg ports
+    for (size_t i = 0; i < worker->get_num_outputs(); i++)
+    {
+        data->output_msg_pressure[i].clear();
     }
+    data->outputs_backpressure.reset();
 
     //tell the upstream and downstram to re-check their tokens
     //this is how the other blocks know who is interested,
@@ -62,6 +78,9 @@ void BlockActor::mark_done(void)
         worker->post_downstream(i, InputCheckMessage());
     }
 
+    //the final stats, a done block never publishes again
+    this->publish_stats();
+
     if (DONE_PRINTS) std::cerr
         << "==================================================\n"
         << "== The " << name << " is done...\n"
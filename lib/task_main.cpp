@@ -1,6 +1,7 @@
 // Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
 
 #include <gras_impl/block_actor.hpp>
+#include <gras_impl/perf_counters.hpp>
 #include <algorithm>
 
 using namespace gras;
@@ -8,14 +9,6 @@ using namespace gras;
 /***********************************************************************
  * main task helper functions used in this file
  **********************************************************************/
-static GRAS_FORCE_INLINE void sort_tags(boost::shared_ptr<BlockData> &data, const size_t i)
-{
-    if GRAS_LIKELY(not data->input_tags_changed[i]) return;
-    std::vector<Tag> &tags_i = data->input_tags[i];
-    std::sort(tags_i.begin(), tags_i.end());
-    data->input_tags_changed[i] = false;
-}
-
 static GRAS_FORCE_INLINE void trim_tags(boost::shared_ptr<BlockData> &data, const size_t i)
 {
     //------------------------------------------------------------------
@@ -23,21 +16,17 @@ static GRAS_FORCE_INLINE void trim_tags(boost::shared_ptr<BlockData> &data, cons
     //-- and post trimmed tags to the downstream based on policy
     //------------------------------------------------------------------
 
-    std::vector<Tag> &tags_i = data->input_tags[i];
-    const item_index_t items_consumed_i = data->stats.items_consumed[i];
-    size_t last = 0;
-    while (last < tags_i.size() and tags_i[last].offset < items_consumed_i)
-    {
-        last++;
-    }
+    TagStore &tags_i = data->input_tags[i];
+    const size_t last = tags_i.count_before(data->stats.items_consumed[i]);
 
     if GRAS_LIKELY(last == 0) return;
 
     //call the overloaded propagate_tags to do the dirty work
-    data->block->propagate_tags(i, TagIter(tags_i.begin(), tags_i.begin()+last));
+    const TagIter all = tags_i.all();
+    data->block->propagate_tags(i, TagIter(all.begin(), all.begin()+last));
 
-    //now its safe to perform the erasure
-    tags_i.erase(tags_i.begin(), tags_i.begin()+last);
+    //now its safe to trim the front of the ring
+    tags_i.pop_front(last);
     data->stats.tags_consumed[i] += last;
 }
 
@@ -46,8 +35,7 @@ static GRAS_FORCE_INLINE void trim_msgs(boost::shared_ptr<BlockData> &data, cons
     const size_t num_read = data->num_input_msgs_read[i];
     if GRAS_UNLIKELY(num_read > 0)
     {
-        std::vector<PMCC> &input_msgs = data->input_msgs[i];
-        input_msgs.erase(input_msgs.begin(), input_msgs.begin()+num_read);
+        data->input_msgs[i].pop_front(num_read);
     }
 }
 
@@ -60,12 +48,70 @@ static GRAS_FORCE_INLINE void trim_buffs(boost::shared_ptr<BlockData> &data, con
     }
 }
 
+static GRAS_FORCE_INLINE void record_latency(boost::shared_ptr<BlockData> &data, const size_t i, const time_ticks_t now)
+{
+    //------------------------------------------------------------------
+    //-- record the latency of the stamped input buffers
+    //-- that were fully consumed by the work call at time now
+    //------------------------------------------------------------------
+
+    std::deque<LatencyStamp> &stamps = data->input_latency_stamps[i];
+    size_t bytes = data->num_input_items_read[i]*data->input_configs[i].item_size;
+    while (bytes != 0 and not stamps.empty())
+    {
+        LatencyStamp &stamp = stamps.front();
+        if (stamp.bytes > bytes)
+        {
+            stamp.bytes -= bytes;
+            return;
+        }
+        bytes -= stamp.bytes;
+        data->input_queue_latency[i].record(now - stamp.produce_time);
+        data->input_source_latency[i].record(now - stamp.origin_time);
+        stamps.pop_front();
+    }
+}
+
+static GRAS_FORCE_INLINE time_ticks_t get_work_origin_time(boost::shared_ptr<BlockData> &data, const size_t num_inputs, const time_ticks_t now)
+{
+    //the origin of the outputs is the origin of the oldest input,
+    //or this block when there are no stamped inputs (like a source)
+    time_ticks_t origin = now;
+    for (size_t i = 0; i < num_inputs; i++)
+    {
+        const std::deque<LatencyStamp> &stamps = data->input_latency_stamps[i];
+        if (not stamps.empty()) origin = std::min(origin, stamps.front().origin_time);
+    }
+    return origin;
+}
+
+static GRAS_FORCE_INLINE void call_work(BlockActor &actor)
+{
+    //------------------------------------------------------------------
+    //-- call work and account for its time, hardware events,
+    //-- and duration; shared by the stream and message-only tasks
+    //------------------------------------------------------------------
+
+    boost::shared_ptr<BlockData> &data = actor.data;
+    data->stats.work_count++;
+    time_ticks_t work_start;
+    {
+        PerfCounterAccumulate pc_work(data->stats, data->perf_counters);
+        TimerAccumulate ta_work(data->stats.total_time_work);
+        actor.task_work();
+        work_start = ta_work.start;
+    }
+    data->stats.time_last_work = time_now();
+    data->work_time_histogram.record(data->stats.time_last_work - work_start);
+}
+
 /***********************************************************************
  * main task
  **********************************************************************/
 void BlockActor::task_main(void)
 {
     TimerAccumulate ta_prep(data->stats.total_time_prep);
+    this->update_stats(ta_prep.start);
 
     //------------------------------------------------------------------
     //-- Decide if its possible to continue any processing:
@@ -73,6 +119,14 @@ void BlockActor::task_main(void)
     //-- however, not all ports may have available buffers.
     //------------------------------------------------------------------
     if GRAS_UNLIKELY(not this->is_work_allowed()) return;
+    TaskScope task_scope(data.get());
+
+    //message-only blocks take the short path
+    if GRAS_UNLIKELY(data->message_only)
+    {
+        ta_prep.done();
+        return this->task_msgs();
+    }
 
     const size_t num_inputs = worker->get_num_inputs();
     const size_t num_outputs = worker->get_num_outputs();
@@ -85,7 +139,6 @@ void BlockActor::task_main(void)
     data->input_items.max() = 0;
     for (size_t i = 0; i < num_inputs; i++)
     {
-        sort_tags(data, i);
         data->num_input_items_read[i] = 0;
         data->num_input_msgs_read[i] = 0;
 
@@ -136,36 +189,35 @@ void BlockActor::task_main(void)
         data->output_items.max() = std::max(data->output_items.max(), items);
     }
 
+    if GRAS_UNLIKELY(data->latency_tracking)
+    {
+        data->work_origin_time = get_work_origin_time(data, num_inputs, ta_prep.start);
+    }
+
     //------------------------------------------------------------------
     //-- the work
     //------------------------------------------------------------------
     ta_prep.done();
-    data->stats.work_count++;
-    if GRAS_UNLIKELY(data->interruptible_thread)
-    {
-        TimerAccumulate ta_work(data->stats.total_time_work);
-        data->interruptible_thread->call();
-    }
-    else
-    {
-        TimerAccumulate ta_work(data->stats.total_time_work);
-        this->task_work();
-    }
-    data->stats.time_last_work = time_now();
+    call_work(*this);
     TimerAccumulate ta_post(data->stats.total_time_post);
 
     //------------------------------------------------------------------
     //-- Post-work input tasks
     //------------------------------------------------------------------
+    size_t items_in = 0;
     for (size_t i = 0; i < num_inputs; i++)
     {
+        items_in += data->num_input_items_read[i];
+
         //call consumption routines to free up resources
         trim_msgs(data, i);
         trim_tags(data, i);
+        if GRAS_UNLIKELY(data->latency_tracking) record_latency(data, i, ta_prep.start);
         trim_buffs(data, i);
 
         //update the inputs available bit field
         this->update_input_avail(i);
+        this->update_msg_pressure(i);
 
         //finally update consumed count --affects get_consumed
         data->total_items_consumed[i] += data->num_input_items_read[i];
@@ -174,10 +226,17 @@ void BlockActor::task_main(void)
     //------------------------------------------------------------------
     //-- Post-work output tasks
     //------------------------------------------------------------------
+    size_t items_out = 0;
     for (size_t i = 0; i < num_outputs; i++)
     {
+        items_out += data->num_output_items_read[i];
+
         //buffer may be popped by one of the special buffer api hooks
-        if GRAS_UNLIKELY(data->output_queues.empty(i)) continue;
+        if GRAS_UNLIKELY(data->output_queues.empty(i))
+        {
+            this->post_output_tags(i);
+            continue;
+        }
 
         //grab a copy of the front buffer then consume from the queue
         InputBufferMessage buff_msg;
@@ -187,12 +246,69 @@ void BlockActor::task_main(void)
         //Post a buffer message downstream only if the produce flag was marked.
         //So this explicitly after consuming the output queues so pop is called.
         //This is because pop may have special hooks in it to prepare the buffer.
-        if GRAS_LIKELY(data->num_output_items_read[i]) worker->post_downstream(i, buff_msg);
+        //The tags posted during work travel downstream with the buffer.
+        if GRAS_LIKELY(data->num_output_items_read[i])
+        {
+            if GRAS_UNLIKELY(data->latency_tracking)
+            {
+                buff_msg.produce_time = data->stats.time_last_work;
+                buff_msg.origin_time = data->work_origin_time;
+            }
+            this->take_output_tags(i, buff_msg.tags);
+            trace_instant("buffer_post", this);
+            worker->post_downstream(i, buff_msg);
+        }
+        else this->post_output_tags(i);
 
         //finally update produced count --affects get_produced
         data->total_items_produced[i] += data->num_output_items_read[i];
     }
 
+    //the distributions of items per call
+    if GRAS_LIKELY(num_inputs != 0) data->input_items_histogram.record(items_in);
+    if GRAS_LIKELY(num_outputs != 0) data->output_items_histogram.record(items_out);
+
     //still have IO ready? kick off another task
     this->task_kicker();
 }
+
+/***********************************************************************
+ * message-only task
+ **********************************************************************/
+void BlockActor::task_msgs(void)
+{
+    //------------------------------------------------------------------
+    //-- A message-only block has no stream buffers to setup:
+    //-- the work buffers stay empty and only the msg queues
+    //-- and tags are trimmed after work, the read counts start at zero.
+    //------------------------------------------------------------------
+    if GRAS_UNLIKELY(not this->is_work_allowed()) return;
+    TaskScope task_scope(data.get());
+
+    call_work(*this);
+    TimerAccumulate ta_post(data->stats.total_time_post);
+    this->update_stats(data->stats.time_last_work);
+
+    const size_t num_inputs = worker->get_num_inputs();
+    for (size_t i = 0; i < num_inputs; i++)
+    {
+        trim_msgs(data, i);
+        data->num_input_msgs_read[i] = 0;
+        trim_tags(data, i);
+        this->update_input_avail(i);
+        this->update_msg_pressure(i);
+    }
+
+    //tags posted during work have no buffer to ride on
+    const size_t num_outputs = worker->get_num_outputs();
+    for (size_t i = 0; i < num_outputs; i++)
+    {
+        this->post_output_tags(i);
+    }
+
+    //the upstream is done and its last msgs were handled
+    if GRAS_UNLIKELY(data->inputs_done.all() and data->inputs_available.none()) return this->mark_done();
+
+    //still have msgs? kick off another task
+    this->task_kicker();
+}
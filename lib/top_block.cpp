@@ -2,6 +2,7 @@
 
 #include "element_impl.hpp"
 #include <gras/top_block.hpp>
+#include <gras_impl/query_server.hpp>
 #include <boost/thread/thread.hpp> //sleep
 
 using namespace gras;
@@ -16,7 +17,7 @@ TopBlock::TopBlock(const std::string &name):
 {
     (*this)->executor.reset(new Apology::Executor((*this)->topology.get()));
     (*this)->token = Token::make();
-    (*this)->thread_group = SharedThreadGroup(new boost::thread_group());
+    (*this)->cancel_token = CancelToken::make();
 }
 
 TopBlock::~TopBlock(void)
@@ -26,6 +27,7 @@ TopBlock::~TopBlock(void)
 
 void ElementImpl::top_block_cleanup(void)
 {
+    this->query_server.reset();
     this->bcast_prio_msg(TopInertMessage());
     this->topology->clear_all();
     this->executor->commit();
@@ -46,8 +48,13 @@ void TopBlock::start(void)
 {
     (*this)->executor->commit();
     {
-        TopThreadMessage message;
-        message.thread_group = (*this)->thread_group;
+        //a previous stop() used up the token, make a fresh one
+        if ((*this)->cancel_token.cancelled())
+        {
+            (*this)->cancel_token = CancelToken::make();
+        }
+        TopCancelMessage message;
+        message.cancel_token = (*this)->cancel_token;
         (*this)->bcast_prio_msg(message);
     }
     {
@@ -71,8 +78,8 @@ void TopBlock::start(void)
 
 void TopBlock::stop(void)
 {
-    //interrupt these "special" threads
-    (*this)->thread_group->interrupt_all();
+    //wake up work routines that wait on the cancel token
+    (*this)->cancel_token.cancel();
 
     //message all blocks to mark done
     (*this)->bcast_prio_msg(TopInertMessage());
@@ -95,12 +102,6 @@ static const boost::posix_time::time_duration INPUT_DONE_GRACE_PERIOD = boost::p
 
 void TopBlock::wait(void)
 {
-    //We do not need to join "special" threads;
-    //the token mechainism will do just fine.
-    //FIXME it might be nice to uncomment this for some nice quiet wait(),
-    //however, thread group cant be joined twice and this breaks some qa code
-    //(*this)->thread_group->join_all();
-
     //QA lockup detection setup
     bool lockup_debug = getenv("GRAS_LOCKUP_DEBUG") != NULL;
     boost::system_time check_done_time = boost::get_system_time();
@@ -152,3 +153,15 @@ bool TopBlock::wait(const double timeout)
 
     return (*this)->token.unique();
 }
+
+unsigned short TopBlock::start_query_server(const unsigned short port, const std::string &assets_dir, const std::string &bind_address)
+{
+    (*this)->query_server.reset(); //free the old port first
+    (*this)->query_server.reset(new QueryServer(this->get(), port, assets_dir, bind_address));
+    return (*this)->query_server->port();
+}
+
+void TopBlock::stop_query_server(void)
+{
+    (*this)->query_server.reset();
+}
@@ -6,47 +6,73 @@
 #include <boost/format.hpp>
 #include <Theron/DefaultAllocator.h>
 #include <algorithm>
+#include <cstdio>
+#include <map>
 #include <set>
 
 using namespace gras;
 
 using namespace boost::property_tree;
 
-struct GetStatsReceiver : Theron::Receiver
+struct StatsEntry
 {
-    GetStatsReceiver(void)
+    std::string block_id;
+    BlockStats stats;
+    time_ticks_t stats_time;
+};
+
+static std::vector<StatsEntry> read_stats_entries(ElementImpl *self, const std::vector<std::string> &block_ids)
+{
+    //read the published stats snapshots, busy blocks are never waited on
+    std::vector<StatsEntry> entries;
+    BOOST_FOREACH(Apology::Worker *w, self->topology->get_workers())
     {
-        this->RegisterHandler(this, &GetStatsReceiver::handle_get_stats);
+        BlockActor *actor = dynamic_cast<BlockActor *>(w->get_actor());
+
+        //filter workers not needed in query, empty block list means all blocks
+        const std::string id = actor->data->block->get_uid();
+        if (not block_ids.empty() and std::find(block_ids.begin(), block_ids.end(), id) == block_ids.end()) continue;
+
+        StatsEntry entry;
+        entry.block_id = id;
+        if (not actor->data->stats_snapshot.read(entry.stats, entry.stats_time)) continue;
+        entries.push_back(entry);
     }
+    return entries;
+}
 
-    void handle_get_stats(const GetStatsMessage &message, const Theron::Address)
+static std::set<ThreadPool> get_thread_pools(ElementImpl *self)
+{
+    std::set<ThreadPool> thread_pools;
+    BOOST_FOREACH(Apology::Worker *w, self->topology->get_workers())
     {
-        this->messages.push_back(message);
+        BlockActor *actor = dynamic_cast<BlockActor *>(w->get_actor());
+        thread_pools.insert(actor->thread_pool);
     }
+    return thread_pools;
+}
 
-    std::vector<GetStatsMessage> messages;
-};
-
-static ptree query_blocks(ElementImpl *self, const ptree &)
+static void query_blocks(ElementImpl *self, const ptree &, JsonWriter &json)
 {
-    ptree root;
-    ptree e;
+    json.begin_object();
+    json.key("blocks");
+    json.begin_object();
     BOOST_FOREACH(Apology::Worker *w, self->topology->get_workers())
     {
         BlockActor *actor = dynamic_cast<BlockActor *>(w->get_actor());
-        ptree prop_e;
+        json.key(actor->data->block->get_uid());
+        json.begin_object();
         BOOST_FOREACH(const std::string &key, actor->data->block->get_registered_names())
         {
-            ptree pname; pname.put_value(key);
-            prop_e.push_back(std::make_pair("call", pname));
+            json.field("call", key);
         }
-        e.push_back(std::make_pair(actor->data->block->get_uid(), prop_e));
+        json.end_object();
     }
-    root.push_back(std::make_pair("blocks", e));
-    return root;
+    json.end_object();
+    json.end_object();
 }
 
-static ptree query_stats(ElementImpl *self, const ptree &query)
+static void query_stats(ElementImpl *self, const ptree &query, JsonWriter &json)
 {
     //parse list of block ids needed in this query
     std::vector<std::string> block_ids;
@@ -58,109 +84,70 @@ static ptree query_stats(ElementImpl *self, const ptree &query)
         }
     }
 
-    //get stats with custom receiver and set high prio
-    GetStatsReceiver receiver;
-    size_t outstandingCount(0);
-    BOOST_FOREACH(Apology::Worker *w, self->topology->get_workers())
-    {
-        BlockActor *actor = dynamic_cast<BlockActor *>(w->get_actor());
-
-        //filter workers not needed in query
-        const std::string id = actor->data->block->get_uid();
-        if (std::find(block_ids.begin(), block_ids.end(), id) == block_ids.end()) continue;
+    //an empty block list means no blocks for this query
+    const time_ticks_t now = time_now();
+    std::vector<StatsEntry> entries;
+    if (not block_ids.empty()) entries = read_stats_entries(self, block_ids);
 
-        //send a message to the block's actor to query stats
-        GetStatsMessage message;
-        message.prio_token = actor->prio_token;
-        actor->GetFramework().Send(message, receiver.GetAddress(), actor->GetAddress());
-        outstandingCount++;
-    }
-    while (outstandingCount) outstandingCount -= receiver.Wait(outstandingCount);
+    //a delta query skips the blocks that did not publish since then
+    const time_ticks_t since = query.get<time_ticks_t>("since", 0);
 
     //create root level node
-    ptree root;
-    root.put("now", time_now());
-    root.put("tps", time_tps());
+    json.begin_object();
+    json.field("now", now);
+    json.field("tps", time_tps());
 
     //allocator debugs
     Theron::DefaultAllocator *allocator = dynamic_cast<Theron::DefaultAllocator *>(Theron::AllocatorManager::Instance().GetAllocator());
     if (allocator)
     {
-        root.put("default_allocator_bytes_allocated", allocator->GetBytesAllocated());
-        root.put("default_allocator_peak_bytes_allocated", allocator->GetPeakBytesAllocated());
-        root.put("default_allocator_allocation_count", allocator->GetAllocationCount());
+        json.field("default_allocator_bytes_allocated", allocator->GetBytesAllocated());
+        json.field("default_allocator_peak_bytes_allocated", allocator->GetPeakBytesAllocated());
+        json.field("default_allocator_allocation_count", allocator->GetAllocationCount());
     }
 
     //thread pool counts
-    std::set<ThreadPool> thread_pools;
-    BOOST_FOREACH(Apology::Worker *w, self->topology->get_workers())
-    {
-        BlockActor *actor = dynamic_cast<BlockActor *>(w->get_actor());
-        thread_pools.insert(actor->thread_pool);
-    }
-    ptree tp_e;
-    BOOST_FOREACH(const ThreadPool &tp, thread_pools)
+    json.key("thread_pools");
+    json.begin_array();
+    BOOST_FOREACH(const ThreadPool &tp, get_thread_pools(self))
     {
-        ptree t;
-        t.put("framework_counter_messages_processed", tp->GetCounterValue(Theron::COUNTER_MESSAGES_PROCESSED));
-        t.put("framework_counter_yields", tp->GetCounterValue(Theron::COUNTER_YIELDS));
-        t.put("framework_counter_local_pushes", tp->GetCounterValue(Theron::COUNTER_LOCAL_PUSHES));
-        t.put("framework_counter_shared_pushes", tp->GetCounterValue(Theron::COUNTER_SHARED_PUSHES));
-        t.put("framework_counter_mailbox_queue_max", tp->GetCounterValue(Theron::COUNTER_MAILBOX_QUEUE_MAX));
-        tp_e.push_back(std::make_pair("", t));
+        json.begin_object();
+        json.field("framework_counter_messages_processed", tp->GetCounterValue(Theron::COUNTER_MESSAGES_PROCESSED));
+        json.field("framework_counter_yields", tp->GetCounterValue(Theron::COUNTER_YIELDS));
+        json.field("framework_counter_local_pushes", tp->GetCounterValue(Theron::COUNTER_LOCAL_PUSHES));
+        json.field("framework_counter_shared_pushes", tp->GetCounterValue(Theron::COUNTER_SHARED_PUSHES));
+        json.field("framework_counter_mailbox_queue_max", tp->GetCounterValue(Theron::COUNTER_MAILBOX_QUEUE_MAX));
+        json.end_object();
     }
-    root.push_back(std::make_pair("thread_pools", tp_e));
+    json.end_array();
 
     //iterate through blocks
-    ptree blocks;
-    BOOST_FOREACH(const GetStatsMessage &message, receiver.messages)
+    json.key("blocks");
+    json.begin_object();
+    BOOST_FOREACH(const StatsEntry &entry, entries)
     {
-        const BlockStats &stats = message.stats;
-        ptree block;
-        block.put("tps", time_tps());
-        block.put("stats_time", message.stats_time);
-        block.put("init_time", stats.init_time);
-        block.put("start_time", stats.start_time);
-        block.put("stop_time", stats.stop_time);
-        block.put("work_count", stats.work_count);
-        block.put("time_last_work", stats.time_last_work);
-        block.put("total_time_prep", stats.total_time_prep);
-        block.put("total_time_work", stats.total_time_work);
-        block.put("total_time_post", stats.total_time_post);
-        block.put("total_time_input", stats.total_time_input);
-        block.put("total_time_output", stats.total_time_output);
-        block.put("actor_queue_depth", stats.actor_queue_depth);
-        #define my_block_ptree_append(l) { \
-            ptree e; \
-            for (size_t i = 0; i < stats.l.size(); i++) { \
-                ptree t; t.put_value(stats.l[i]); \
-                e.push_back(std::make_pair("", t)); \
-            } \
-            block.push_back(std::make_pair(#l, e)); \
-        }
-        my_block_ptree_append(items_enqueued);
-        my_block_ptree_append(tags_enqueued);
-        my_block_ptree_append(msgs_enqueued);
-        my_block_ptree_append(items_consumed);
-        my_block_ptree_append(tags_consumed);
-        my_block_ptree_append(msgs_consumed);
-        my_block_ptree_append(items_produced);
-        my_block_ptree_append(tags_produced);
-        my_block_ptree_append(msgs_produced);
-        my_block_ptree_append(bytes_copied);
-        my_block_ptree_append(inputs_idle);
-        my_block_ptree_append(outputs_idle);
-        blocks.push_back(std::make_pair(message.block_id, block));
+        if (entry.stats_time <= since) continue;
+        const BlockStats &stats = entry.stats;
+        json.key(entry.block_id);
+        json.begin_object();
+        json.field("tps", time_tps());
+        json.field("stats_time", entry.stats_time);
+        json.field("stats_age", std::max(now, entry.stats_time) - entry.stats_time); //ticks since the snapshot
+        #define my_block_json_field(l) json.field(#l, stats.l);
+        GRAS_BLOCK_STATS_SCALARS(my_block_json_field)
+        GRAS_BLOCK_STATS_VECTORS(my_block_json_field)
+        #undef my_block_json_field
+        json.end_object();
     }
-    root.push_back(std::make_pair("blocks", blocks));
-    return root;
+    json.end_object();
+    json.end_object();
 }
 
-static ptree query_calls(ElementImpl *self, const ptree &query)
+static void query_calls(ElementImpl *self, const ptree &query, JsonWriter &json)
 {
-    ptree root;
     const std::string block_id = query.get<std::string>("block");
     const std::string call_name = query.get<std::string>("name");
+    json.begin_object();
     BOOST_FOREACH(Apology::Worker *w, self->topology->get_workers())
     {
         BlockActor *actor = dynamic_cast<BlockActor *>(w->get_actor());
@@ -174,12 +161,12 @@ static ptree query_calls(ElementImpl *self, const ptree &query)
             }
         }
         const PMCC p = actor->data->block->Block::_handle_call(call_name, PMC_M(args));
-        ptree v = pmc_to_ptree(p);
-        root.push_back(std::make_pair("block", query.get_child("block")));
-        root.push_back(std::make_pair("name", query.get_child("name")));
-        root.push_back(std::make_pair("value", v));
+        json.field("block", block_id);
+        json.field("name", call_name);
+        json.key("value");
+        pmc_to_json(json, p);
     }
-    return root;
+    json.end_object();
 }
 
 static std::string query_topology(ElementImpl *self, const ptree &query)
@@ -260,6 +247,346 @@ static std::string query_topology(ElementImpl *self, const ptree &query)
     return buff;
 }
 
+/***********************************************************************
+ * OpenMetrics text exposition, written straight into a string
+ **********************************************************************/
+static void metrics_family(std::string &buff, const char *name, const char *type, const char *unit, const char *help)
+{
+    buff += "# TYPE gras_"; buff += name; buff += " "; buff += type; buff += "\n";
+    if (unit[0] != '\0')
+    {
+        buff += "# UNIT gras_"; buff += name; buff += " "; buff += unit; buff += "\n";
+    }
+    buff += "# HELP gras_"; buff += name; buff += " "; buff += help; buff += "\n";
+}
+
+static void metrics_label(std::string &buff, const char *key, const std::string &value)
+{
+    buff += key; buff += "=\"";
+    BOOST_FOREACH(const char ch, value)
+    {
+        if (ch == '\\') buff += "\\\\";
+        else if (ch == '"') buff += "\\\"";
+        else if (ch == '\n') buff += "\\n";
+        else buff += ch;
+    }
+    buff += "\"";
+}
+
+static void metrics_value(std::string &buff, const item_index_t value)
+{
+    char s[32];
+    std::sprintf(s, " %llu\n", value);
+    buff += s;
+}
+
+static void metrics_value(std::string &buff, const double value)
+{
+    char s[32];
+    std::sprintf(s, " %.9g\n", value);
+    buff += s;
+}
+
+static void metrics_sample(std::string &buff, const char *name, const bool counter, const std::string &block_id)
+{
+    buff += "gras_"; buff += name;
+    if (counter) buff += "_total";
+    buff += "{"; metrics_label(buff, "block", block_id); buff += "}";
+}
+
+static void metrics_sample(std::string &buff, const char *name, const bool counter, const std::string &block_id, const char *port_key, const size_t port)
+{
+    buff += "gras_"; buff += name;
+    if (counter) buff += "_total";
+    buff += "{"; metrics_label(buff, "block", block_id);
+    buff += ","; buff += port_key; buff += "=\"";
+    char s[32]; std::sprintf(s, "%u", unsigned(port)); buff += s;
+    buff += "\"}";
+}
+
+template <typename T>
+static void metrics_block_family(
+    std::string &buff, const std::vector<StatsEntry> &entries,
+    const char *name, const bool counter, const char *help, T BlockStats::*member
+){
+    metrics_family(buff, name, counter? "counter" : "gauge", "", help);
+    BOOST_FOREACH(const StatsEntry &entry, entries)
+    {
+        metrics_sample(buff, name, counter, entry.block_id);
+        metrics_value(buff, item_index_t(entry.stats.*member));
+    }
+}
+
+static void metrics_time_family(
+    std::string &buff, const std::vector<StatsEntry> &entries,
+    const char *name, const char *help, time_ticks_t BlockStats::*member
+){
+    const double tps = double(time_tps());
+    metrics_family(buff, name, "counter", "seconds", help);
+    BOOST_FOREACH(const StatsEntry &entry, entries)
+    {
+        metrics_sample(buff, name, true, entry.block_id);
+        metrics_value(buff, (entry.stats.*member)/tps);
+    }
+}
+
+template <typename T>
+static void metrics_port_family(
+    std::string &buff, const std::vector<StatsEntry> &entries,
+    const char *name, const bool counter, const char *help,
+    std::vector<T> BlockStats::*member, const char *port_key
+){
+    metrics_family(buff, name, counter? "counter" : "gauge", "", help);
+    BOOST_FOREACH(const StatsEntry &entry, entries)
+    {
+        const std::vector<T> &v = entry.stats.*member;
+        for (size_t i = 0; i < v.size(); i++)
+        {
+            metrics_sample(buff, name, counter, entry.block_id, port_key, i);
+            metrics_value(buff, item_index_t(v[i]));
+        }
+    }
+}
+
+static void metrics_port_time_family(
+    std::string &buff, const std::vector<StatsEntry> &entries,
+    const char *name, const char *help,
+    std::vector<time_ticks_t> BlockStats::*member, const char *port_key
+){
+    const double tps = double(time_tps());
+    metrics_family(buff, name, "counter", "seconds", help);
+    BOOST_FOREACH(const StatsEntry &entry, entries)
+    {
+        const std::vector<time_ticks_t> &v = entry.stats.*member;
+        for (size_t i = 0; i < v.size(); i++)
+        {
+            metrics_sample(buff, name, true, entry.block_id, port_key, i);
+            metrics_value(buff, v[i]/tps);
+        }
+    }
+}
+
+static std::string query_metrics(ElementImpl *self, const ptree &)
+{
+    const std::vector<StatsEntry> entries = read_stats_entries(self, std::vector<std::string>());
+    std::string buff;
+    buff.reserve(256*entries.size() + 4096);
+
+    //per block counters
+    metrics_block_family(buff, entries, "work_calls", true, "Calls into the block's work.", &BlockStats::work_count);
+    metrics_time_family(buff, entries, "work_time_seconds", "Time spent in work.", &BlockStats::total_time_work);
+    metrics_time_family(buff, entries, "prep_time_seconds", "Time spent preparing for work.", &BlockStats::total_time_prep);
+    metrics_time_family(buff, entries, "post_time_seconds", "Time spent after work.", &BlockStats::total_time_post);
+    metrics_time_family(buff, entries, "input_time_seconds", "Time spent handling input messages.", &BlockStats::total_time_input);
+    metrics_time_family(buff, entries, "output_time_seconds", "Time spent handling output messages.", &BlockStats::total_time_output);
+    metrics_block_family(buff, entries, "actor_queue_depth", false, "Messages queued on the block's actor.", &BlockStats::actor_queue_depth);
+    metrics_block_family(buff, entries, "perf_cycles", true, "CPU cycles counted in work.", &BlockStats::perf_cycles);
+    metrics_block_family(buff, entries, "perf_instructions", true, "Instructions retired in work.", &BlockStats::perf_instructions);
+    metrics_block_family(buff, entries, "perf_cache_misses", true, "Last level cache misses in work.", &BlockStats::perf_cache_misses);
+    metrics_block_family(buff, entries, "perf_branch_misses", true, "Branch mispredictions in work.", &BlockStats::perf_branch_misses);
+
+    //per input port counters
+    metrics_port_family(buff, entries, "items_consumed", true, "Items consumed on an input port.", &BlockStats::items_consumed, "input");
+    metrics_port_family(buff, entries, "tags_consumed", true, "Tags consumed on an input port.", &BlockStats::tags_consumed, "input");
+    metrics_port_family(buff, entries, "msgs_consumed", true, "Messages consumed on an input port.", &BlockStats::msgs_consumed, "input");
+    metrics_port_family(buff, entries, "bytes_copied", true, "Bytes copied to accumulate input buffers.", &BlockStats::bytes_copied, "input");
+    metrics_port_time_family(buff, entries, "input_idle_seconds", "Time that an input port was not ready.", &BlockStats::inputs_idle, "input");
+    metrics_port_family(buff, entries, "items_enqueued", false, "Items queued on an input port.", &BlockStats::items_enqueued, "input");
+    metrics_port_family(buff, entries, "tags_enqueued", false, "Tags queued on an input port.", &BlockStats::tags_enqueued, "input");
+    metrics_port_family(buff, entries, "msgs_enqueued", false, "Messages queued on an input port.", &BlockStats::msgs_enqueued, "input");
+    metrics_port_family(buff, entries, "msgs_high_water", false, "Most messages ever queued on an input port.", &BlockStats::msgs_high_water, "input");
+
+    //per output port counters
+    metrics_port_family(buff, entries, "items_produced", true, "Items produced on an output port.", &BlockStats::items_produced, "output");
+    metrics_port_family(buff, entries, "tags_produced", true, "Tags produced on an output port.", &BlockStats::tags_produced, "output");
+    metrics_port_family(buff, entries, "tags_dropped", true, "Tags dropped without a downstream subscriber.", &BlockStats::tags_dropped, "output");
+    metrics_port_family(buff, entries, "msgs_produced", true, "Messages produced on an output port.", &BlockStats::msgs_produced, "output");
+    metrics_port_family(buff, entries, "msg_buffers_hit", true, "Message buffers reused from the port pool.", &BlockStats::msg_buffers_hit, "output");
+    metrics_port_family(buff, entries, "msg_buffers_miss", true, "Message buffers allocated for the port pool.", &BlockStats::msg_buffers_miss, "output");
+    metrics_port_time_family(buff, entries, "output_idle_seconds", "Time that an output port was not ready.", &BlockStats::outputs_idle, "output");
+
+    //per thread pool counters
+    const std::set<ThreadPool> thread_pools = get_thread_pools(self);
+    #define my_metrics_pool_family(name, counter, help, id) { \
+        metrics_family(buff, name, counter? "counter" : "gauge", "", help); \
+        size_t pool_index = 0; \
+        BOOST_FOREACH(const ThreadPool &tp, thread_pools) { \
+            buff += "gras_"; buff += name; if (counter) buff += "_total"; \
+            char s[32]; std::sprintf(s, "{pool=\"%u\"}", unsigned(pool_index++)); buff += s; \
+            metrics_value(buff, item_index_t(tp->GetCounterValue(id))); \
+        } \
+    }
+    my_metrics_pool_family("pool_messages_processed", true, "Messages processed by the thread pool.", Theron::COUNTER_MESSAGES_PROCESSED);
+    my_metrics_pool_family("pool_yields", true, "Worker thread yields in the thread pool.", Theron::COUNTER_YIELDS);
+    my_metrics_pool_family("pool_local_pushes", true, "Mailboxes pushed onto a worker's local queue.", Theron::COUNTER_LOCAL_PUSHES);
+    my_metrics_pool_family("pool_shared_pushes", true, "Mailboxes pushed onto the shared queue.", Theron::COUNTER_SHARED_PUSHES);
+    my_metrics_pool_family("pool_mailbox_queue_max", false, "Most messages ever queued in a mailbox.", Theron::COUNTER_MAILBOX_QUEUE_MAX);
+
+    //allocator counters
+    Theron::DefaultAllocator *allocator = dynamic_cast<Theron::DefaultAllocator *>(Theron::AllocatorManager::Instance().GetAllocator());
+    if (allocator)
+    {
+        metrics_family(buff, "allocator_bytes", "gauge", "bytes", "Bytes held by the message allocator.");
+        buff += "gras_allocator_bytes"; metrics_value(buff, item_index_t(allocator->GetBytesAllocated()));
+        metrics_family(buff, "allocator_peak_bytes", "gauge", "bytes", "Most bytes ever held by the message allocator.");
+        buff += "gras_allocator_peak_bytes"; metrics_value(buff, item_index_t(allocator->GetPeakBytesAllocated()));
+        metrics_family(buff, "allocator_allocations", "counter", "", "Allocations by the message allocator.");
+        buff += "gras_allocator_allocations_total"; metrics_value(buff, item_index_t(allocator->GetAllocationCount()));
+    }
+
+    buff += "# EOF\n";
+    return buff;
+}
+
+/***********************************************************************
+ * Bottleneck analysis from the published stats
+ **********************************************************************/
+struct BottleneckEntry
+{
+    Apology::Worker *worker;
+    std::string block_id;
+    double utilization; //fraction of the time spent in work
+    double input_idle; //fraction of the time the most idle input waited
+    double output_idle; //fraction of the time the most idle output waited
+    double throughput; //items per second through the ports
+    const char *state;
+    bool compute_bound;
+};
+
+static bool bottleneck_entry_compare(const BottleneckEntry &a, const BottleneckEntry &b)
+{
+    return a.utilization > b.utilization;
+}
+
+static double bottleneck_max_fraction(const std::vector<time_ticks_t> &idle, const double elapsed)
+{
+    double max_fraction = 0.0;
+    for (size_t i = 0; i < idle.size(); i++)
+    {
+        max_fraction = std::max(max_fraction, idle[i]/elapsed);
+    }
+    return std::min(max_fraction, 1.0);
+}
+
+static void query_bottleneck(ElementImpl *self, const ptree &, JsonWriter &json)
+{
+    //the fraction of time under which a block is considered idle
+    const double idle_fraction = 0.05;
+
+    //classify every block from its stats
+    std::vector<BottleneckEntry> entries;
+    BOOST_FOREACH(Apology::Worker *w, self->topology->get_workers())
+    {
+        BlockActor *actor = dynamic_cast<BlockActor *>(w->get_actor());
+        BlockStats stats;
+        time_ticks_t stats_time;
+        if (not actor->data->stats_snapshot.read(stats, stats_time)) continue;
+        if (stats.start_time == 0) continue; //never activated
+
+        //the stats of a done block end at its stop time
+        time_ticks_t end_time = stats_time;
+        if (stats.stop_time != 0 and stats.stop_time < end_time) end_time = stats.stop_time;
+        const double elapsed = double(end_time - stats.start_time);
+        if (elapsed <= 0) continue;
+
+        BottleneckEntry entry;
+        entry.worker = w;
+        entry.block_id = actor->data->block->get_uid();
+        entry.utilization = std::min(stats.total_time_work/elapsed, 1.0);
+        entry.input_idle = bottleneck_max_fraction(stats.inputs_idle, elapsed);
+        entry.output_idle = bottleneck_max_fraction(stats.outputs_idle, elapsed);
+        item_index_t items = 0;
+        for (size_t i = 0; i < stats.items_consumed.size(); i++) items += stats.items_consumed[i];
+        for (size_t i = 0; i < stats.items_produced.size(); i++) items += stats.items_produced[i];
+        entry.throughput = (double(items)*time_tps())/elapsed;
+
+        //the block is limited by whatever it spends the most time on
+        const double most = std::max(entry.utilization, std::max(entry.input_idle, entry.output_idle));
+        entry.compute_bound = most >= idle_fraction and most == entry.utilization;
+        if (most < idle_fraction) entry.state = "idle";
+        else if (entry.compute_bound) entry.state = "compute_bound";
+        else if (most == entry.output_idle) entry.state = "backpressured";
+        else entry.state = "starved";
+        entries.push_back(entry);
+    }
+    std::sort(entries.begin(), entries.end(), &bottleneck_entry_compare);
+
+    std::map<Apology::Worker *, size_t> entry_index;
+    for (size_t i = 0; i < entries.size(); i++) entry_index[entries[i].worker] = i;
+
+    //the upstream workers of each worker in the flat flows
+    std::map<Apology::Worker *, std::vector<Apology::Worker *> > upstreams;
+    BOOST_FOREACH(const Apology::Flow &flow, self->topology->get_flat_flows())
+    {
+        Apology::Worker *src = dynamic_cast<Apology::Worker *>(flow.src.elem);
+        Apology::Worker *dst = dynamic_cast<Apology::Worker *>(flow.dst.elem);
+        upstreams[dst].push_back(src);
+    }
+
+    json.begin_object();
+    json.field("now", time_now());
+    json.field("tps", time_tps());
+
+    //ranked list, the most utilized blocks first
+    json.key("blocks");
+    json.begin_array();
+    BOOST_FOREACH(const BottleneckEntry &entry, entries)
+    {
+        json.begin_object();
+        json.field("block", entry.block_id);
+        json.field("state", entry.state);
+        json.field("utilization", entry.utilization);
+        json.field("input_idle", entry.input_idle);
+        json.field("output_idle", entry.output_idle);
+        json.field("throughput", entry.throughput);
+        json.end_object();
+    }
+    json.end_array();
+
+    //every path ends in a sink, the rate limiting block of a path
+    //is the most utilized compute bound block upstream of the sink
+    json.key("paths");
+    json.begin_array();
+    BOOST_FOREACH(Apology::Worker *sink, self->topology->get_workers())
+    {
+        if (sink->get_num_outputs() != 0) continue;
+        std::set<Apology::Worker *> visited;
+        std::vector<Apology::Worker *> pending(1, sink);
+        size_t limiting = entries.size(); //most utilized block
+        size_t limiting_compute = entries.size(); //most utilized compute bound block
+        size_t num_blocks = 0;
+        while (not pending.empty())
+        {
+            Apology::Worker *w = pending.back();
+            pending.pop_back();
+            if (not visited.insert(w).second) continue;
+            num_blocks++;
+            const std::vector<Apology::Worker *> &ups = upstreams[w];
+            pending.insert(pending.end(), ups.begin(), ups.end());
+
+            //entries are ranked, so the lowest index is the most utilized
+            if (entry_index.count(w) == 0) continue;
+            const size_t i = entry_index[w];
+            limiting = std::min(limiting, i);
+            if (entries[i].compute_bound) limiting_compute = std::min(limiting_compute, i);
+        }
+        if (limiting_compute < entries.size()) limiting = limiting_compute;
+        json.begin_object();
+        json.field("sink", dynamic_cast<BlockActor *>(sink->get_actor())->data->block->get_uid());
+        json.field("num_blocks", num_blocks);
+        if (limiting < entries.size())
+        {
+            json.field("bottleneck", entries[limiting].block_id);
+            json.field("state", entries[limiting].state);
+            json.field("utilization", entries[limiting].utilization);
+        }
+        json.end_object();
+    }
+    json.end_array();
+
+    json.end_object();
+}
+
 std::string TopBlock::query(const std::string &args)
 {
     //convert json args into property tree
@@ -267,10 +594,14 @@ std::string TopBlock::query(const std::string &args)
 
     //dispatch based on path arg
     std::string path = query.get<std::string>("path");
-    ptree result;
+    JsonWriter json;
     if (path == "/topology.dot") return query_topology(this->get(), query);
-    if (path == "/blocks.json") result = query_blocks(this->get(), query);
-    if (path == "/stats.json") result = query_stats(this->get(), query);
-    if (path == "/calls.json") result = query_calls(this->get(), query);
-    return ptree_to_json(result);
+    if (path == "/metrics") return query_metrics(this->get(), query);
+    if (path == "/trace.json") return this->capture_trace(query.get<double>("seconds", 1.0));
+    if (path == "/blocks.json") query_blocks(this->get(), query, json);
+    if (path == "/stats.json") query_stats(this->get(), query, json);
+    if (path == "/calls.json") query_calls(this->get(), query, json);
+    if (path == "/bottleneck.json") query_bottleneck(this->get(), query, json);
+    if (json.str().empty()) return "{}";
+    return json.str();
 }
@@ -0,0 +1,77 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#include "element_impl.hpp"
+#include <gras_impl/trace.hpp>
+#include <gras_impl/json_writer.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/foreach.hpp>
+#include <map>
+
+using namespace gras;
+
+std::string TopBlock::capture_trace(const double seconds)
+{
+    //the actors are the event sources, map them to block ids
+    std::map<const void *, std::string> block_ids;
+    BOOST_FOREACH(Apology::Worker *w, (*this)->topology->get_workers())
+    {
+        BlockActor *actor = dynamic_cast<BlockActor *>(w->get_actor());
+        block_ids[static_cast<const void *>(actor)] = actor->data->block->get_uid();
+    }
+
+    const std::vector<TraceThreadEvents> threads = trace_capture(seconds);
+
+    //timestamps are microseconds from the first event
+    time_ticks_t start = 0;
+    BOOST_FOREACH(const TraceThreadEvents &thread, threads)
+    {
+        const time_ticks_t first = thread.events.front().time;
+        if (start == 0 or first < start) start = first;
+    }
+    const double us_per_tick = 1e6/time_tps();
+
+    JsonWriter json;
+    json.begin_object();
+    json.key("traceEvents");
+    json.begin_array();
+    BOOST_FOREACH(const TraceThreadEvents &thread, threads)
+    {
+        //name the thread row and report events lost to a full ring
+        json.begin_object();
+        json.field("name", "thread_name");
+        json.field("ph", "M");
+        json.field("pid", 1);
+        json.field("tid", thread.thread_index);
+        json.key("args");
+        json.begin_object();
+        json.field("name", "gras thread " + boost::lexical_cast<std::string>(thread.thread_index));
+        json.field("dropped", thread.num_dropped);
+        json.end_object();
+        json.end_object();
+
+        BOOST_FOREACH(const TraceEvent &event, thread.events)
+        {
+            //events from actors of another top block are skipped
+            std::map<const void *, std::string>::const_iterator it = block_ids.find(event.source);
+            if (it == block_ids.end()) continue;
+
+            json.begin_object();
+            json.field("name", event.name);
+            json.field("cat", "gras");
+            json.field("ph", std::string(1, event.phase));
+            json.field("ts", (event.time - start)*us_per_tick);
+            json.field("pid", 1);
+            json.field("tid", thread.thread_index);
+            if (event.phase == 'i') json.field("s", "t");
+            json.key("args");
+            json.begin_object();
+            json.field("block", it->second);
+            json.end_object();
+            json.end_object();
+        }
+    }
+    json.end_array();
+    json.field("displayTimeUnit", "ns");
+    json.end_object();
+    return json.str();
+}
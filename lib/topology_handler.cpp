@@ -40,7 +40,10 @@ void BlockActor::handle_topology(
     resize_fill_grow(data->stats.msgs_consumed, num_inputs, 0);
     resize_fill_grow(data->stats.items_produced, num_outputs, 0);
     resize_fill_grow(data->stats.tags_produced, num_outputs, 0);
+    resize_fill_grow(data->stats.tags_dropped, num_outputs, 0);
     resize_fill_grow(data->stats.msgs_produced, num_outputs, 0);
+    resize_fill_grow(data->stats.msg_buffers_hit, num_outputs, 0);
+    resize_fill_grow(data->stats.msg_buffers_miss, num_outputs, 0);
 
     //resize all work buffers to match current connections
     data->input_items.resize(num_inputs);
@@ -64,12 +67,23 @@ void BlockActor::handle_topology(
     data->output_allocation_hints.resize(num_outputs);
 
     //resize tags vector to match sizes
-    data->input_tags_changed.resize(num_inputs);
     data->input_tags.resize(num_inputs);
+    data->output_tags.resize(num_outputs);
+    data->output_tag_subscriptions.resize(num_outputs);
+    data->outputs_backpressure.resize(num_outputs);
+    data->output_msg_pressure.resize(num_outputs);
+    {
+        boost::mutex::scoped_lock l(data->output_msg_pools_mutex);
+        data->output_msg_pools.resize(num_outputs);
+    }
+    data->output_msg_buffer_pools.resize(num_outputs);
     data->num_input_msgs_read.resize(num_inputs);
     data->num_input_items_read.resize(num_inputs);
     data->num_output_items_read.resize(num_outputs);
     data->input_msgs.resize(num_inputs);
+    data->input_latency_stamps.resize(num_inputs);
+    data->input_queue_latency.resize(num_inputs);
+    data->input_source_latency.resize(num_inputs);
 
     //a block looses all connections, allow it to free
     if (num_inputs == 0 and num_outputs == 0)
@@ -90,5 +104,8 @@ void BlockActor::handle_topology(
         this->handle_output_update(message, Theron::Address());
     }
 
+    //publish stats with the new port counts
+    this->publish_stats();
+
     this->Send(0, from); //ACK
 }
@@ -0,0 +1,130 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#include <gras_impl/trace.hpp>
+#include <gras_impl/stats_snapshot.hpp> //stats_memory_barrier
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+#include <boost/shared_ptr.hpp>
+#include <algorithm>
+
+using namespace gras;
+
+volatile bool gras::trace_capturing = false;
+
+/***********************************************************************
+ * A ring per recording thread:
+ * Only its own thread writes into the ring, and the capture
+ * reads the ring after recording stops, so there are no locks.
+ * Despite the name, the ring is not circular: it fills up,
+ * and then drops and counts events until the next capture.
+ * The writer resets a ring that is from an older capture,
+ * so the reader never has to touch the write position.
+ **********************************************************************/
+struct TraceRing
+{
+    enum {CAPACITY = 1 << 15};
+
+    TraceRing(const size_t thread_index):
+        thread_index(thread_index),
+        generation(0),
+        head(0),
+        num_dropped(0),
+        events(CAPACITY)
+    {}
+
+    const size_t thread_index;
+    size_t generation;
+    volatile size_t head;
+    size_t num_dropped;
+    std::vector<TraceEvent> events;
+};
+
+static boost::mutex trace_mutex; //protects the list of rings
+static boost::mutex capture_mutex; //one capture at a time
+static volatile size_t trace_generation = 0;
+
+static std::vector<boost::shared_ptr<TraceRing> > &get_trace_rings(void)
+{
+    static std::vector<boost::shared_ptr<TraceRing> > rings;
+    return rings;
+}
+
+//the registry owns the rings, so that they outlive their threads
+static void null_cleanup(TraceRing *){}
+
+static TraceRing *get_thread_ring(void)
+{
+    static boost::thread_specific_ptr<TraceRing> thread_ring(&null_cleanup);
+    if GRAS_UNLIKELY(thread_ring.get() == NULL)
+    {
+        boost::mutex::scoped_lock l(trace_mutex);
+        std::vector<boost::shared_ptr<TraceRing> > &rings = get_trace_rings();
+        rings.push_back(boost::shared_ptr<TraceRing>(new TraceRing(rings.size())));
+        thread_ring.reset(rings.back().get());
+    }
+    return thread_ring.get();
+}
+
+void gras::trace_record(const char *name, const char phase, const void *source)
+{
+    TraceRing *ring = get_thread_ring();
+
+    //this ring is left over from an older capture
+    const size_t generation = trace_generation;
+    if GRAS_UNLIKELY(ring->generation != generation)
+    {
+        ring->generation = generation;
+        ring->num_dropped = 0;
+        ring->head = 0;
+    }
+
+    const size_t index = ring->head;
+    if GRAS_UNLIKELY(index >= TraceRing::CAPACITY)
+    {
+        ring->num_dropped++;
+        return;
+    }
+
+    TraceEvent &event = ring->events[index];
+    event.time = time_now();
+    event.name = name;
+    event.source = source;
+    event.phase = phase;
+    stats_memory_barrier();
+    ring->head = index + 1;
+}
+
+std::vector<TraceThreadEvents> gras::trace_capture(const double seconds)
+{
+    boost::mutex::scoped_lock capture_lock(capture_mutex);
+    const double duration = std::max(0.0, std::min(seconds, TRACE_MAX_SECONDS));
+
+    //start a new generation and let the threads record
+    trace_generation = trace_generation + 1;
+    stats_memory_barrier();
+    trace_capturing = true;
+    boost::this_thread::sleep(boost::posix_time::microseconds(long(duration*1e6)));
+    trace_capturing = false;
+
+    //grace period for a record that saw the flag before it was cleared
+    boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+    stats_memory_barrier();
+
+    std::vector<TraceThreadEvents> result;
+    boost::mutex::scoped_lock l(trace_mutex);
+    const std::vector<boost::shared_ptr<TraceRing> > &rings = get_trace_rings();
+    for (size_t i = 0; i < rings.size(); i++)
+    {
+        const TraceRing &ring = *rings[i];
+        if (ring.generation != trace_generation) continue;
+        const size_t num_events = ring.head;
+        if (num_events == 0) continue;
+        TraceThreadEvents thread_events;
+        thread_events.thread_index = ring.thread_index;
+        thread_events.num_dropped = ring.num_dropped;
+        thread_events.events.assign(ring.events.begin(), ring.events.begin() + num_events);
+        result.push_back(thread_events);
+    }
+    return result;
+}
@@ -20,6 +20,9 @@
 %import <PMC/PMC.i>
 %import <gras/element.i>
 %include <gras/gras.hpp>
+
+//the background jit is for C++, python uses the blocking jit factory
+%ignore gras::jit_factory_async;
 %include <gras/factory.hpp>
 
 ////////////////////////////////////////////////////////////////////////
@@ -54,4 +57,9 @@ def py_jit_factory(*args):
     try_load_dll("gras")
     try_load_dll("pmc")
     jit_factory(*args)
+
+def py_jit_factory_batch(*args):
+    try_load_dll("gras")
+    try_load_dll("pmc")
+    jit_factory_batch(*args)
 %}
@@ -13,6 +13,8 @@
 %feature("nodirector") gras::BlockPython::notify_topology;
 %feature("nodirector") gras::BlockPython::work;
 %feature("nodirector") gras::BlockPython::_handle_call_ts;
+%feature("nodirector") gras::BlockPython::_handle_call_typed;
+%feature("nodirector") gras::BlockPython::_handle_call_async;
 
 ////////////////////////////////////////////////////////////////////////
 // http://www.swig.org/Doc2.0/Library.html#Library_stl_exceptions
@@ -66,6 +68,36 @@
 ////////////////////////////////////////////////////////////////////////
 // Make a special block with safe overloads
 ////////////////////////////////////////////////////////////////////////
+%{
+
+namespace gras
+{
+
+//dummy registry entry that should not really be called!
+//the signature never matches a typed call from a call handle,
+//so handles always fall back to calling the python method by name
+struct BlockPythonDummyEntry : CallableRegistryEntry
+{
+    PMCC call(const PMCC &)
+    {
+        throw std::runtime_error("BlockPython dummy method called -- should not happen!");
+    }
+
+    const std::type_info &signature(void) const
+    {
+        return typeid(void);
+    }
+
+    void call_typed(const void *const *, void *)
+    {
+        throw std::runtime_error("BlockPython dummy method called -- should not happen!");
+    }
+};
+
+}
+
+%}
+
 %inline %{
 
 namespace gras
@@ -174,13 +206,7 @@ struct BlockPython : Block
     //dummy registration so the C++ knows at least the name names
     void dummy_register_call(const std::string &name)
     {
-        this->register_call(name, &BlockPython::__my_dummy);
-    }
-
-    //dummy call that should not really be called!
-    void __my_dummy(void)
-    {
-        throw std::runtime_error("BlockPython dummy method called -- should not happen!");
+        this->_register_call(name, new BlockPythonDummyEntry());
     }
 };
 
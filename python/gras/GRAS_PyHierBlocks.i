@@ -111,6 +111,12 @@ struct TopBlockPython : TopBlock
         PyTSPhondler phil;
         return TopBlock::query(args);
     }
+
+    std::string capture_trace(const double seconds)
+    {
+        PyTSPhondler phil;
+        return TopBlock::capture_trace(seconds);
+    }
 };
 
 struct HierBlockPython : HierBlock
@@ -15,6 +15,9 @@ var gras_chart_get_registry = function()
         {key:'port_counters', name:'Port Counters', factory:GrasChartPortCounts},
         {key:'global_counters', name:'Global Counters', factory:GrasChartGlobalCounts},
         {key:'port_downtime', name:'Port downtime', factory:GrasChartPortDowntime},
+        {key:'latency', name:'Input Latency', factory:GrasChartLatency},
+        {key:'ipc', name:'Instructions per Cycle', factory:GrasChartIpc},
+        {key:'cache_misses', name:'Cache Miss Rate', factory:GrasChartCacheMisses},
         {key:'topology_display', name:'Topology Display', factory:GrasChartTopologyDisplay},
     ];
 }
@@ -284,6 +287,6 @@ function gras_chart_factory_init(registry)
         overall_rate.val(registry.overall_rate);
         overall_active.attr('checked', registry.overall_active);
         handle_gui_event();
-        gras_query_stats(registry);
+        gras_stream_stats(registry);
     });
 }
@@ -0,0 +1,59 @@
+function GrasChartLatency(args, panel)
+{
+    //input checking
+    if (args.block_ids.length != 1) throw gras_error_dialog(
+        "GrasChartLatency",
+        "Error making latency chart.\n"+
+        "Specify only one block for this chart."
+    );
+
+    //save enable
+    this.block_id = args.block_ids[0];
+
+    //make new chart
+    this.chart = new google.visualization.ColumnChart(panel);
+
+    this.title = "Input Latency in ms - " + this.block_id;
+    this.default_width = GRAS_CHARTS_STD_WIDTH;
+}
+
+GrasChartLatency.prototype.update = function(point)
+{
+    var block_data = point.blocks[this.block_id];
+    if (!block_data) return;
+    if (!block_data.latency_samples) return;
+
+    var raw_data = new Array();
+    raw_data.push(['Percentile']); //key
+    var rows = [['p50', '_latency_p50'], ['p90', '_latency_p90'], ['p99', '_latency_p99'], ['max', '_latency_max']];
+    $.each(rows, function(row_i, row)
+    {
+        raw_data.push([row[0]]);
+    });
+
+    //a queue and a source series for each tracked input port
+    $.each(block_data.latency_samples, function(index, samples)
+    {
+        if (samples == 0) return;
+        $.each(['queue', 'source'], function(which_i, which)
+        {
+            raw_data[0].push(which + index.toString());
+            $.each(rows, function(row_i, row)
+            {
+                var ticks = block_data[which + row[1]][index];
+                raw_data[row_i+1].push(1e3*ticks/block_data.tps);
+            });
+        });
+    });
+    if (raw_data[0].length == 1) return;
+
+    //update the chart from raw data
+    var data = google.visualization.arrayToDataTable(raw_data);
+    var options = {
+        legend: {'position': 'bottom'},
+    };
+    if (this.gc_resize) options.width = 50;
+    if (this.gc_resize) options.height = 50;
+
+    this.chart.draw(data, options);
+};
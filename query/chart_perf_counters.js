@@ -0,0 +1,65 @@
+function GrasChartPerfCounters(args, panel, title, num_key, den_key, scale)
+{
+    //save enables
+    this.ids = args.block_ids;
+
+    //input checking
+    if (this.ids.length == 0) throw gras_error_dialog(
+        "GrasChartPerfCounters",
+        "Error making hardware counters chart.\n"+
+        "Specify at least 1 block for this chart."
+    );
+
+    //make new chart
+    this.chart = new google.visualization.LineChart(panel);
+
+    this.title = title;
+    this.num_key = num_key;
+    this.den_key = den_key;
+    this.scale = scale;
+    this.history = new Array();
+    this.default_width = 2*GRAS_CHARTS_STD_WIDTH;
+}
+
+GrasChartPerfCounters.prototype.update = function(point)
+{
+    this.history.push(point);
+    if (this.history.length == 1) this.p0 = point;
+    if (this.history.length < 2) return;
+    if (this.history.length > 10) this.history.splice(0, 1);
+
+    var data_set = [['Time'].concat(this.ids)];
+    for (var i = 1; i < this.history.length; i++)
+    {
+        var row = new Array();
+        row.push(gras_extract_stat_time_delta(this.p0, this.history[i]).toFixed(2).toString());
+        for (var j = 0; j < this.ids.length; j++)
+        {
+            row.push(gras_extract_perf_ratio_delta(this.history[i-1], this.history[i], this.ids[j], this.num_key, this.den_key, this.scale));
+        }
+        data_set.push(row);
+    }
+
+    var chart_data = google.visualization.arrayToDataTable(data_set);
+    var options = {
+        title: this.title,
+        legend: {'position': 'bottom'},
+    };
+    if (this.gc_resize) options.width = 50;
+    if (this.gc_resize) options.height = 50;
+    this.chart.draw(chart_data, options);
+};
+
+function GrasChartIpc(args, panel)
+{
+    return new GrasChartPerfCounters(args, panel,
+        "Instructions per Cycle in work",
+        'perf_instructions', 'perf_cycles', 1);
+}
+
+function GrasChartCacheMisses(args, panel)
+{
+    return new GrasChartPerfCounters(args, panel,
+        "Cache Misses per 1000 Instructions in work",
+        'perf_cache_misses', 'perf_instructions', 1000);
+}
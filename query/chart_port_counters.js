@@ -51,6 +51,8 @@ GrasChartPortCounts.prototype.update = function(point)
         ['Output', 'items', 'items_produced'],
         ['Output', 'tags', 'tags_produced'],
         ['Output', 'msgs', 'msgs_produced'],
+        ['Pooled', 'hits', 'msg_buffers_hit'],
+        ['Pooled', 'misses', 'msg_buffers_miss'],
         ['Copied', 'bytes', 'bytes_copied'],
     ];
 
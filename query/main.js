@@ -58,6 +58,57 @@ var gras_query_stats = function(registry)
     });
 }
 
+/***********************************************************************
+ * Stream stats: the server sends the blocks that changed as events
+ **********************************************************************/
+var gras_stream_stats = function(registry)
+{
+    //servers without an event stream are polled instead
+    if (!window.EventSource) return gras_query_stats(registry);
+
+    var block_ids = gras_chart_factory_active_blocks(registry);
+    var stream_key = JSON.stringify([block_ids, registry.overall_rate]);
+    var url = "/stats.events?" + jQuery.param({blocks:block_ids, rate:registry.overall_rate}, true /*needed to parse data*/);
+    var source = new EventSource(url);
+    var streamed = false;
+
+    source.onmessage = function(event)
+    {
+        streamed = true;
+        registry.online = true;
+        gras_handle_offline(registry);
+
+        //merge the changed blocks into a new point,
+        //charts keep old points, so they are never modified
+        var delta = JSON.parse(event.data);
+        var blocks = $.extend({}, registry.stream_point? registry.stream_point.blocks : {}, delta.blocks);
+        var point = $.extend({}, delta, {blocks:blocks});
+        registry.stream_point = point;
+        if (registry.overall_active) gras_chart_factory_update(registry, point);
+
+        //restart the stream when the charts or the rate change
+        var new_key = JSON.stringify([gras_chart_factory_active_blocks(registry), registry.overall_rate]);
+        if (new_key != stream_key)
+        {
+            source.close();
+            gras_stream_stats(registry);
+        }
+    };
+
+    source.onerror = function()
+    {
+        source.close();
+        registry.stream_point = null;
+        if (!streamed) return gras_query_stats(registry);
+        registry.online = false;
+        gras_handle_offline(registry);
+        window.setTimeout(function()
+        {
+            gras_stream_stats(registry);
+        }, 1000);
+    };
+}
+
 /***********************************************************************
  * Init
  **********************************************************************/
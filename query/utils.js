@@ -46,6 +46,15 @@ var gras_extract_stat_time_delta = function(p0, p1)
     return (t1-t0)/(tps);
 }
 
+var gras_extract_perf_ratio_delta = function(p0, p1, id, num_key, den_key, scale)
+{
+    var d0 = p0.blocks[id];
+    var d1 = p1.blocks[id];
+    var den = d1[den_key] - d0[den_key];
+    if (den == 0) return null; //no work in this interval
+    return (scale*(d1[num_key] - d0[num_key]))/den;
+}
+
 var gras_extract_percent_times = function(point, id)
 {
     var block_data = point.blocks[id];
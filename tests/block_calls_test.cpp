@@ -26,6 +26,7 @@ struct MyBlock : gras::Block
     void set_foo(const size_t &new_foo)
     {
         foo = new_foo;
+        this->publish_call("get_foo", foo);
     }
 
     size_t foo;
@@ -53,3 +54,63 @@ BOOST_AUTO_TEST_CASE(test_callable_errors)
     //wrong type for call
     BOOST_CHECK_THROW(my_block.x("set_foo", "a string"), std::exception);
 }
+
+BOOST_AUTO_TEST_CASE(test_call_handles)
+{
+    MyBlock my_block;
+    gras::CallHandle get_foo = my_block.get_call_handle("get_foo");
+    gras::CallHandle set_foo = my_block.get_call_handle("set_foo");
+
+    //nothing published yet
+    BOOST_CHECK_THROW(get_foo.read<size_t>(), std::exception);
+
+    set_foo.x(size_t(42));
+    BOOST_CHECK_EQUAL(my_block.foo, size_t(42));
+    BOOST_CHECK_EQUAL(get_foo.x<size_t>(), size_t(42));
+    BOOST_CHECK_EQUAL(get_foo.read<size_t>(), size_t(42));
+
+    //wrong type for call
+    BOOST_CHECK_THROW(set_foo.x("a string"), std::exception);
+}
+
+BOOST_AUTO_TEST_CASE(test_calls_async)
+{
+    MyBlock my_block0, my_block1;
+
+    gras::CallFuture set0 = my_block0.call_async("set_foo", size_t(1));
+    gras::CallFuture set1 = my_block1.call_async("set_foo", size_t(2));
+    BOOST_CHECK(set0.wait());
+    BOOST_CHECK(set1.wait());
+    BOOST_CHECK(set0.ready());
+    BOOST_CHECK_EQUAL(my_block0.foo, size_t(1));
+    BOOST_CHECK_EQUAL(my_block1.foo, size_t(2));
+
+    gras::CallFuture get1 = my_block1.call_async("get_foo");
+    BOOST_CHECK_EQUAL(get1.get<size_t>(), size_t(2));
+
+    //errors come out of the future
+    gras::CallFuture get_bar = my_block0.call_async("get_bar");
+    BOOST_CHECK_THROW(get_bar.get<size_t>(), std::exception);
+    BOOST_CHECK(not get_bar.get_error().empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_calls_batch)
+{
+    MyBlock my_block0, my_block1;
+
+    gras::CallBatch batch;
+    batch.add(my_block0.call_async("set_foo", size_t(3)));
+    batch.add(my_block1.call_async("set_foo", size_t(4)));
+    BOOST_CHECK_EQUAL(batch.size(), size_t(2));
+    batch.wait();
+    BOOST_CHECK_EQUAL(my_block0.foo, size_t(3));
+    BOOST_CHECK_EQUAL(my_block1.foo, size_t(4));
+
+    //the batch waits on every call and then throws
+    gras::CallBatch bad_batch;
+    bad_batch.add(my_block0.call_async("set_foo", "a string"));
+    bad_batch.add(my_block1.call_async("set_foo", size_t(5)));
+    BOOST_CHECK_THROW(bad_batch.wait(), std::exception);
+    BOOST_CHECK(bad_batch[1].ready());
+    BOOST_CHECK_EQUAL(my_block1.foo, size_t(5));
+}
@@ -0,0 +1,229 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#include <boost/test/unit_test.hpp>
+#include <iostream>
+#include <vector>
+#include <string>
+
+#include <gras/block.hpp>
+#include <gras/top_block.hpp>
+
+static const int NUM_MSGS = 100; //more than a pool preallocates
+
+//! A message value that counts the live copies of itself
+struct MyCounted
+{
+    MyCounted(const int value = 0):
+        value(value)
+    {
+        ++num_live;
+    }
+
+    MyCounted(const MyCounted &other):
+        value(other.value)
+    {
+        ++num_live;
+    }
+
+    ~MyCounted(void)
+    {
+        --num_live;
+    }
+
+    int value;
+    static boost::detail::atomic_count num_live;
+};
+
+boost::detail::atomic_count MyCounted::num_live(0);
+
+BOOST_AUTO_TEST_CASE(test_msg_slot_reuse)
+{
+    boost::shared_ptr<gras::MsgSlotPoolT<MyCounted> > pool(new gras::MsgSlotPoolT<MyCounted>());
+
+    //the last reference destroys the value and returns the slot
+    const gras::MsgSlot *first = NULL;
+    {
+        gras::MsgSlotPtr slot = pool->make(MyCounted(1));
+        gras::MsgSlotPtr copy = slot;
+        first = slot.get();
+        BOOST_CHECK_EQUAL(long(MyCounted::num_live), 1);
+    }
+    BOOST_CHECK_EQUAL(long(MyCounted::num_live), 0);
+
+    //the next value is made in the returned slot
+    gras::MsgSlotPtr slot = pool->make(MyCounted(2));
+    BOOST_CHECK_EQUAL(slot.get(), first);
+    BOOST_CHECK_EQUAL(static_cast<const gras::MsgSlotT<MyCounted> &>(*slot).value().value, 2);
+}
+
+//! Posts numbered typed messages, and a string between each
+struct MyMsgSource : gras::Block
+{
+    MyMsgSource(void):
+        gras::Block("MyMsgSource")
+    {
+        this->output_config(0).item_size = 4;
+    }
+
+    void work(const InputItems &, const OutputItems &)
+    {
+        for (int i = 0; i < NUM_MSGS; i++)
+        {
+            this->post_output_msg(0, MyCounted(i));
+            this->post_output_msg(0, std::string("hello"));
+        }
+        this->mark_done();
+    }
+};
+
+//! Pops the messages with the typed pop_input_msg
+struct MyTypedMsgSink : gras::Block
+{
+    MyTypedMsgSink(void):
+        gras::Block("MyTypedMsgSink")
+    {
+        this->global_config().message_only = true;
+    }
+
+    void work(const InputItems &, const OutputItems &)
+    {
+        while (true)
+        {
+            MyCounted counted;
+            std::string str;
+            if (this->pop_input_msg(0, counted)) values.push_back(counted.value);
+            else if (this->pop_input_msg(0, str)) strs.push_back(str);
+            else break;
+        }
+    }
+
+    std::vector<int> values;
+    std::vector<std::string> strs;
+};
+
+//! Pops the messages boxed with the PMC pop_input_msg
+struct MyPMCMsgSink : gras::Block
+{
+    MyPMCMsgSink(void):
+        gras::Block("MyPMCMsgSink")
+    {
+        this->global_config().message_only = true;
+    }
+
+    void work(const InputItems &, const OutputItems &)
+    {
+        while (true)
+        {
+            const PMCC msg = this->pop_input_msg(0);
+            if (not msg) break;
+            msgs.push_back(msg);
+        }
+    }
+
+    std::vector<PMCC> msgs;
+};
+
+BOOST_AUTO_TEST_CASE(test_typed_msgs_fan_out)
+{
+    {
+        MyMsgSource source;
+        MyTypedMsgSink typed_sink;
+        MyPMCMsgSink pmc_sink;
+        gras::TopBlock tb("Top");
+        tb.connect(source, 0, typed_sink, 0);
+        tb.connect(source, 0, pmc_sink, 0);
+        tb.run();
+
+        //the typed consumer copies the values out of the slots
+        BOOST_REQUIRE_EQUAL(typed_sink.values.size(), size_t(NUM_MSGS));
+        BOOST_REQUIRE_EQUAL(typed_sink.strs.size(), size_t(NUM_MSGS));
+        for (int i = 0; i < NUM_MSGS; i++)
+        {
+            BOOST_CHECK_EQUAL(typed_sink.values[i], i);
+            BOOST_CHECK_EQUAL(typed_sink.strs[i], "hello");
+        }
+
+        //the PMC consumer of the same slots gets the values boxed
+        BOOST_REQUIRE_EQUAL(pmc_sink.msgs.size(), size_t(2*NUM_MSGS));
+        for (int i = 0; i < NUM_MSGS; i++)
+        {
+            BOOST_REQUIRE(pmc_sink.msgs[2*i].is<MyCounted>());
+            BOOST_CHECK_EQUAL(pmc_sink.msgs[2*i].as<MyCounted>().value, i);
+            BOOST_REQUIRE(pmc_sink.msgs[2*i+1].is<std::string>());
+            BOOST_CHECK_EQUAL(pmc_sink.msgs[2*i+1].as<std::string>(), "hello");
+        }
+        pmc_sink.msgs.clear();
+    }
+
+    //every slot returned its value when the last consumer was done
+    BOOST_CHECK_EQUAL(long(MyCounted::num_live), 0);
+}
+
+//! Posts one numbered message per work call
+struct MyMsgCounter : gras::Block
+{
+    MyMsgCounter(void):
+        gras::Block("MyMsgCounter"),
+        count(0)
+    {
+        this->output_config(0).item_size = 4;
+    }
+
+    void work(const InputItems &, const OutputItems &)
+    {
+        this->post_output_msg(0, count);
+        if (++count == NUM_MSGS) this->mark_done();
+    }
+
+    int count;
+};
+
+//! A message-only block, pops one message per work call
+struct MyMsgOnly : gras::Block
+{
+    MyMsgOnly(const bool relay):
+        gras::Block("MyMsgOnly"),
+        relay(relay),
+        saw_items(false)
+    {
+        this->global_config().message_only = true;
+        this->input_config(0).maximum_msgs = 2;
+    }
+
+    void work(const InputItems &ins, const OutputItems &outs)
+    {
+        if (ins.size() != 0 and ins[0].size() != 0) saw_items = true;
+        if (outs.size() != 0 and outs[0].size() != 0) saw_items = true;
+        int value = 0;
+        if (not this->pop_input_msg(0, value)) return;
+        values.push_back(value);
+        if (relay) this->post_output_msg(0, value);
+    }
+
+    const bool relay;
+    bool saw_items;
+    std::vector<int> values;
+};
+
+BOOST_AUTO_TEST_CASE(test_msg_only_backpressure)
+{
+    //the short queues fill up, and the producers only
+    //finish when the consumers release the backpressure
+    MyMsgCounter source;
+    MyMsgOnly relay(true);
+    MyMsgOnly sink(false);
+    gras::TopBlock tb("Top");
+    tb.connect(source, 0, relay, 0);
+    tb.connect(relay, 0, sink, 0);
+    tb.run();
+
+    BOOST_CHECK(not relay.saw_items);
+    BOOST_CHECK(not sink.saw_items);
+    BOOST_REQUIRE_EQUAL(relay.values.size(), size_t(NUM_MSGS));
+    BOOST_REQUIRE_EQUAL(sink.values.size(), size_t(NUM_MSGS));
+    for (int i = 0; i < NUM_MSGS; i++)
+    {
+        BOOST_CHECK_EQUAL(relay.values[i], i);
+        BOOST_CHECK_EQUAL(sink.values[i], i);
+    }
+}
@@ -0,0 +1,74 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#include <boost/test/unit_test.hpp>
+#include <iostream>
+
+#include <gras/block.hpp>
+
+struct MyParams
+{
+    MyParams(void):
+        gain(1.0), offset(0){}
+    double gain;
+    long offset;
+};
+
+struct MyParamsBlock : gras::Block
+{
+    MyParamsBlock(void):
+        gras::Block("MyParamsBlock")
+    {
+        this->register_params("params", params);
+    }
+
+    //dummy work
+    void work(const InputItems &, const OutputItems &){}
+
+    gras::BlockParams<MyParams> params;
+};
+
+BOOST_AUTO_TEST_CASE(test_block_params_latch)
+{
+    gras::BlockParams<MyParams> params;
+    BOOST_CHECK_EQUAL(params.get().gain, 1.0);
+
+    //nothing new until written
+    BOOST_CHECK(not params.latch());
+
+    //a write is not seen until latched
+    MyParams p;
+    p.gain = 2.0;
+    p.offset = 42;
+    params.set(p);
+    BOOST_CHECK_EQUAL(params.get().gain, 1.0);
+    BOOST_CHECK(params.latch());
+    BOOST_CHECK_EQUAL(params.get().gain, 2.0);
+    BOOST_CHECK_EQUAL(params.get().offset, 42);
+    BOOST_CHECK(not params.latch());
+
+    //many writes between latches: the latest one wins
+    for (long i = 0; i < 10; i++)
+    {
+        p.offset = i;
+        params.set(p);
+    }
+    BOOST_CHECK(params.latch());
+    BOOST_CHECK_EQUAL(params.get().offset, 9);
+}
+
+BOOST_AUTO_TEST_CASE(test_block_set_params)
+{
+    MyParamsBlock my_block;
+
+    MyParams p;
+    p.gain = 3.0;
+    my_block.set_params("params", p);
+    BOOST_CHECK(my_block.params.latch());
+    BOOST_CHECK_EQUAL(my_block.params.get().gain, 3.0);
+
+    //params do not exist
+    BOOST_CHECK_THROW(my_block.set_params("foo", p), std::exception);
+
+    //wrong type for params
+    BOOST_CHECK_THROW(my_block.set_params("params", 3.0), std::exception);
+}
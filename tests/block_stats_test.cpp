@@ -0,0 +1,213 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#include <boost/test/unit_test.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/foreach.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+#include <iostream>
+#include <sstream>
+#include <cstring>
+#include <string>
+
+#include <gras/block.hpp>
+#include <gras/top_block.hpp>
+
+static const size_t NUM_ITEMS = 10*1000*1000;
+
+//! Produces items until the total is reached
+struct MyStatsSource : gras::Block
+{
+    MyStatsSource(void):
+        gras::Block("MyStatsSource")
+    {
+        this->output_config(0).item_size = 4;
+        this->set_uid("stats_source");
+    }
+
+    void work(const InputItems &, const OutputItems &outs)
+    {
+        this->produce(0, std::min<size_t>(outs[0].size(), NUM_ITEMS - this->get_produced(0)));
+        if (this->get_produced(0) == NUM_ITEMS) this->mark_done();
+    }
+};
+
+//! Consumes every item
+struct MyStatsSink : gras::Block
+{
+    MyStatsSink(void):
+        gras::Block("MyStatsSink")
+    {
+        this->input_config(0).item_size = 4;
+        this->set_uid("stats_sink");
+    }
+
+    void work(const InputItems &ins, const OutputItems &)
+    {
+        this->consume(0, ins[0].size());
+    }
+};
+
+//! Query the stats of the blocks in a JSON list of block ids
+static boost::property_tree::ptree query_stats(gras::TopBlock &tb, const std::string &block_ids = "\"stats_source\",\"stats_sink\"")
+{
+    std::istringstream result(tb.query("{\"path\":\"/stats.json\",\"blocks\":[" + block_ids + "]}"));
+    boost::property_tree::ptree stats;
+    boost::property_tree::read_json(result, stats);
+    return stats;
+}
+
+//! The count of the only port in a per-port stats vector, or ~0 for any other size
+static unsigned long long get_port_stat(const boost::property_tree::ptree &block, const std::string &name)
+{
+    const boost::property_tree::ptree &ports = block.get_child(name);
+    if (ports.size() != 1) return ~0ULL;
+    return ports.front().second.get_value<unsigned long long>();
+}
+
+struct MyStatsReader
+{
+    MyStatsReader(gras::TopBlock &tb):
+        tb(tb),
+        done(false),
+        num_reads(0),
+        num_errors(0)
+    {}
+
+    void run(void)
+    {
+        unsigned long long last_produced = 0, last_consumed = 0;
+        while (not done)
+        {
+            const boost::property_tree::ptree stats = query_stats(tb);
+            BOOST_FOREACH(const boost::property_tree::ptree::value_type &block, stats.get_child("blocks"))
+            {
+                //a torn snapshot would show as a wrong port count or counts going back
+                const std::string id = block.first;
+                unsigned long long &last = (id == "stats_source")? last_produced : last_consumed;
+                const unsigned long long count = get_port_stat(block.second, (id == "stats_source")? "items_produced" : "items_consumed");
+                if (count < last or count > NUM_ITEMS) num_errors++;
+                last = count;
+                num_reads++;
+            }
+        }
+    }
+
+    gras::TopBlock &tb;
+    volatile bool done;
+    size_t num_reads;
+    size_t num_errors;
+};
+
+BOOST_AUTO_TEST_CASE(test_stats_read_while_running)
+{
+    MyStatsSource source;
+    MyStatsSink sink;
+    gras::TopBlock tb("Top");
+    tb.connect(source, 0, sink, 0);
+
+    //read the snapshots while the blocks keep publishing them
+    MyStatsReader reader(tb);
+    tb.start();
+    boost::thread reader_thread(boost::bind(&MyStatsReader::run, &reader));
+    tb.wait();
+    reader.done = true;
+    reader_thread.join();
+
+    BOOST_CHECK(reader.num_reads > 0);
+    BOOST_CHECK_EQUAL(reader.num_errors, size_t(0));
+
+    //the final snapshots have the final counts
+    const boost::property_tree::ptree stats = query_stats(tb);
+    BOOST_CHECK_EQUAL(get_port_stat(stats.get_child("blocks.stats_source"), "items_produced"), NUM_ITEMS);
+    BOOST_CHECK_EQUAL(get_port_stat(stats.get_child("blocks.stats_sink"), "items_consumed"), NUM_ITEMS);
+    tb.stop();
+}
+
+//! Posts a packet in a pooled buffer per work call
+struct MyPacketSource : gras::Block
+{
+    MyPacketSource(const size_t num_packets):
+        gras::Block("MyPacketSource"),
+        num_packets(num_packets),
+        num_done(0)
+    {
+        this->output_config(0).item_size = 4;
+        this->set_uid("packet_source");
+    }
+
+    void work(const InputItems &, const OutputItems &)
+    {
+        gras::SBuffer buff = this->get_output_msg_buffer(0, 100);
+        std::memset(buff.get(), int(num_done), buff.length);
+        this->post_output_msg(0, gras::PacketMsg(buff));
+        if (++num_done == num_packets) this->mark_done();
+    }
+
+    const size_t num_packets;
+    size_t num_done;
+};
+
+//! Pops the packets, which returns their buffers to the pool
+struct MyPacketSink : gras::Block
+{
+    MyPacketSink(void):
+        gras::Block("MyPacketSink"),
+        num_packets(0)
+    {
+        this->global_config().message_only = true;
+        this->input_config(0).maximum_msgs = 1;
+    }
+
+    void work(const InputItems &, const OutputItems &)
+    {
+        gras::PacketMsg packet;
+        while (this->pop_input_msg(0, packet)) num_packets++;
+    }
+
+    size_t num_packets;
+};
+
+BOOST_AUTO_TEST_CASE(test_msg_buffers_reused)
+{
+    MyPacketSource source(100);
+    MyPacketSink sink;
+    gras::TopBlock tb("Top");
+    tb.connect(source, 0, sink, 0);
+    tb.run();
+    BOOST_CHECK_EQUAL(sink.num_packets, size_t(100));
+
+    //the short queue keeps few packets in flight, so buffers come back
+    const boost::property_tree::ptree stats = query_stats(tb, "\"packet_source\"");
+    const boost::property_tree::ptree &source_stats = stats.get_child("blocks.packet_source");
+    const unsigned long long hits = get_port_stat(source_stats, "msg_buffers_hit");
+    const unsigned long long misses = get_port_stat(source_stats, "msg_buffers_miss");
+    BOOST_CHECK(hits > 0);
+    BOOST_CHECK_EQUAL(hits + misses, 100ULL);
+}
+
+BOOST_AUTO_TEST_CASE(test_latency_histograms)
+{
+    MyStatsSource source;
+    MyStatsSink sink;
+    gras::TopBlock tb("Top");
+    tb.global_config().latency_tracking = true;
+    tb.connect(source, 0, sink, 0);
+    tb.run();
+
+    //every consumed buffer was stamped and recorded into the histograms
+    const boost::property_tree::ptree stats = query_stats(tb, "\"stats_sink\"");
+    const boost::property_tree::ptree &sink_stats = stats.get_child("blocks.stats_sink");
+    BOOST_CHECK(get_port_stat(sink_stats, "latency_samples") > 0);
+    const char *histograms[] = {"queue", "source"};
+    BOOST_FOREACH(const std::string &which, histograms)
+    {
+        const unsigned long long p50 = get_port_stat(sink_stats, which + "_latency_p50");
+        const unsigned long long p90 = get_port_stat(sink_stats, which + "_latency_p90");
+        const unsigned long long p99 = get_port_stat(sink_stats, which + "_latency_p99");
+        const unsigned long long max = get_port_stat(sink_stats, which + "_latency_max");
+        BOOST_CHECK(max > 0);
+        BOOST_CHECK(p50 <= p90 and p90 <= p99 and p99 <= max);
+    }
+}
@@ -0,0 +1,192 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#include <boost/test/unit_test.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/foreach.hpp>
+#include <boost/thread/thread.hpp>
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <vector>
+#include <string>
+
+#include <gras/block.hpp>
+#include <gras/top_block.hpp>
+
+static const size_t ITEMS_PER_WORK = 10;
+
+static gras::Tag make_stream_tag(const gras::item_index_t offset, const std::string &key)
+{
+    return gras::Tag(offset, PMC_M(gras::StreamTag(PMC_M(key))));
+}
+
+//! Tags one item per work call, and holds after the hold count until released
+struct MyTagSource : gras::Block
+{
+    MyTagSource(const size_t num_works, const size_t hold_at = ~0):
+        gras::Block("MyTagSource"),
+        num_works(num_works),
+        hold_at(hold_at),
+        num_done(0),
+        released(false)
+    {
+        this->output_config(0).item_size = 4;
+    }
+
+    void work(const InputItems &, const OutputItems &outs)
+    {
+        if (num_done == hold_at and not released) return;
+        this->post_output_tag(0, make_stream_tag(this->get_produced(0), "work"));
+        this->produce(0, std::min(outs[0].size(), ITEMS_PER_WORK));
+        if (++num_done == num_works) this->mark_done();
+    }
+
+    const size_t num_works;
+    const size_t hold_at;
+    volatile size_t num_done;
+    volatile bool released;
+};
+
+//! Records the keys and offsets of the tags in the consumed items
+struct MyTagSink : gras::Block
+{
+    MyTagSink(void):
+        gras::Block("MyTagSink")
+    {
+        this->input_config(0).item_size = 4;
+    }
+
+    void work(const InputItems &ins, const OutputItems &)
+    {
+        const gras::item_index_t begin = this->get_consumed(0);
+        BOOST_FOREACH(const gras::Tag &t, this->get_input_tags(0, begin, begin + ins[0].size()))
+        {
+            offsets.push_back(t.offset);
+            keys.push_back(t.object.as<gras::StreamTag>().key.as<std::string>());
+        }
+        this->consume(0, ins[0].size());
+    }
+
+    std::vector<gras::item_index_t> offsets;
+    std::vector<std::string> keys;
+};
+
+BOOST_AUTO_TEST_CASE(test_tags_in_and_out_of_work)
+{
+    MyTagSource source(4, 3);
+    MyTagSink sink;
+    gras::TopBlock tb("Top");
+    tb.connect(source, 0, sink, 0);
+    tb.start();
+
+    //post from this thread while the source is held without work to do
+    while (source.num_done != 3) boost::this_thread::yield();
+    source.post_output_tag(0, make_stream_tag(source.get_produced(0), "outside"));
+    source.released = true;
+    tb.wait();
+    tb.stop();
+
+    //the outside tag is delivered in order, ahead of the next work tag
+    BOOST_REQUIRE_EQUAL(sink.keys.size(), size_t(5));
+    const char *expected_keys[] = {"work", "work", "work", "outside", "work"};
+    const size_t expected_offsets[] = {0, 10, 20, 30, 30};
+    for (size_t i = 0; i < sink.keys.size(); i++)
+    {
+        BOOST_CHECK_EQUAL(sink.keys[i], expected_keys[i]);
+        BOOST_CHECK_EQUAL(sink.offsets[i], gras::item_index_t(expected_offsets[i]));
+    }
+}
+
+//! Posts one tag object several times, reassigning its key in between
+struct MyReassignSource : gras::Block
+{
+    MyReassignSource(void):
+        gras::Block("MyReassignSource")
+    {
+        this->output_config(0).item_size = 4;
+    }
+
+    void work(const InputItems &, const OutputItems &)
+    {
+        gras::StreamTag tag(PMC_M(std::string("keep")));
+        this->post_output_tag(0, gras::Tag(0, PMC_M(tag)));
+        tag.key = PMC_M(std::string("drop"));
+        this->post_output_tag(0, gras::Tag(1, PMC_M(tag)));
+        tag.key = PMC_M(std::string("keep"));
+        this->post_output_tag(0, gras::Tag(2, PMC_M(tag)));
+        this->produce(0, ITEMS_PER_WORK);
+        this->mark_done();
+    }
+};
+
+BOOST_AUTO_TEST_CASE(test_tags_reassigned_key)
+{
+    MyReassignSource source;
+    MyTagSink sink;
+    sink.input_config(0).consume_all_tags = false;
+    sink.input_config(0).consumed_tag_keys.push_back(gras::TagKey("keep"));
+    gras::TopBlock tb("Top");
+    tb.connect(source, 0, sink, 0);
+    tb.run();
+
+    //the subscription follows the key that the tag has when posted
+    BOOST_REQUIRE_EQUAL(sink.keys.size(), size_t(2));
+    BOOST_CHECK_EQUAL(sink.keys[0], "keep");
+    BOOST_CHECK_EQUAL(sink.offsets[0], gras::item_index_t(0));
+    BOOST_CHECK_EQUAL(sink.keys[1], "keep");
+    BOOST_CHECK_EQUAL(sink.offsets[1], gras::item_index_t(2));
+}
+
+//! Posts a tag with each key per work call
+struct MyKeysSource : gras::Block
+{
+    MyKeysSource(const size_t num_works):
+        gras::Block("MyKeysSource"),
+        num_works(num_works),
+        num_done(0)
+    {
+        this->output_config(0).item_size = 4;
+        this->set_uid("keys_source");
+    }
+
+    void work(const InputItems &, const OutputItems &outs)
+    {
+        const gras::item_index_t offset = this->get_produced(0);
+        this->post_output_tag(0, make_stream_tag(offset, "keep"));
+        this->post_output_tag(0, make_stream_tag(offset+1, "drop"));
+        this->post_output_tag(0, make_stream_tag(offset+2, "drop"));
+        this->produce(0, std::min(outs[0].size(), ITEMS_PER_WORK));
+        if (++num_done == num_works) this->mark_done();
+    }
+
+    const size_t num_works;
+    size_t num_done;
+};
+
+BOOST_AUTO_TEST_CASE(test_tags_subscribed_key)
+{
+    MyKeysSource source(4);
+    MyTagSink sink;
+    sink.input_config(0).consume_all_tags = false;
+    sink.input_config(0).consumed_tag_keys.push_back(gras::TagKey("keep"));
+    gras::TopBlock tb("Top");
+    tb.connect(source, 0, sink, 0);
+    tb.run();
+
+    //only the subscribed key is delivered
+    BOOST_REQUIRE_EQUAL(sink.keys.size(), size_t(4));
+    for (size_t i = 0; i < sink.keys.size(); i++)
+    {
+        BOOST_CHECK_EQUAL(sink.keys[i], "keep");
+        BOOST_CHECK_EQUAL(sink.offsets[i], gras::item_index_t(i*ITEMS_PER_WORK));
+    }
+
+    //the other keys are dropped at the source and counted
+    std::istringstream result(tb.query("{\"path\":\"/stats.json\",\"blocks\":[\"keys_source\"]}"));
+    boost::property_tree::ptree stats;
+    boost::property_tree::read_json(result, stats);
+    const boost::property_tree::ptree &source_stats = stats.get_child("blocks.keys_source");
+    BOOST_CHECK_EQUAL(source_stats.get_child("tags_produced").front().second.get_value<size_t>(), size_t(4));
+    BOOST_CHECK_EQUAL(source_stats.get_child("tags_dropped").front().second.get_value<size_t>(), size_t(8));
+}
@@ -67,6 +67,15 @@ class BlockTest(unittest.TestCase):
         self.tb.run()
         self.assertEqual(sink.get_values(), values)
 
+    def test_tag_subscription_none(self):
+        values = (0, 'hello', 4.2, True)
+        src = TestUtils.TagSource(values)
+        sink = TestUtils.TagSink()
+        sink.input_config(0).consume_all_tags = False #no tag keys
+        self.tb.connect(src, sink)
+        self.tb.run()
+        self.assertEqual(sink.get_values(), ())
+
     def test_ro_buffers(self):
         class BadTouch(gras.Block):
             def __init__(self, in_sig):
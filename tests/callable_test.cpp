@@ -114,3 +114,38 @@ BOOST_AUTO_TEST_CASE(test_registered_methods)
         BOOST_CHECK_EQUAL(ret, size_t(0));
     }
 }
+
+BOOST_AUTO_TEST_CASE(test_call_handles)
+{
+    MyClass my_class;
+    gras::CallHandle get_count = my_class.get_call_handle("test_args0_with_return");
+    gras::CallHandle set_count = my_class.get_call_handle("test_args1_with_no_return");
+    gras::CallHandle add = my_class.get_call_handle("test_args2_with_return");
+    BOOST_CHECK_EQUAL(add.name(), "test_args2_with_return");
+
+    //exact argument and return types
+    {
+        set_count.x(int(42));
+        int ret = get_count.x<int>();
+        BOOST_CHECK_EQUAL(ret, 42);
+    }
+    {
+        set_count.x(int(1));
+        set_count.x(int(2));
+        int ret = get_count.x<int>();
+        BOOST_CHECK_EQUAL(ret, 2);
+    }
+
+    //other types are converted like a call by name
+    {
+        size_t ret = get_count.x<size_t>();
+        BOOST_CHECK_EQUAL(ret, size_t(2));
+    }
+    {
+        size_t ret = add.x<size_t>(1, "OK");
+        BOOST_CHECK_EQUAL(ret, size_t(3));
+    }
+
+    //call does not exist
+    BOOST_CHECK_THROW(my_class.get_call_handle("test_args4_with_return"), std::exception);
+}
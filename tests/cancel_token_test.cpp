@@ -0,0 +1,76 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#include <boost/test/unit_test.hpp>
+#include <iostream>
+
+#include <gras/cancel_token.hpp>
+#include <gras/chrono.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+static void sleep_then_cancel(const gras::CancelToken &token)
+{
+    boost::this_thread::sleep(boost::posix_time::milliseconds(50));
+    token.cancel();
+}
+
+BOOST_AUTO_TEST_CASE(test_cancel_token_poll)
+{
+    gras::CancelToken null_token;
+    BOOST_CHECK(not null_token.cancelled());
+
+    gras::CancelToken token = gras::CancelToken::make();
+    BOOST_CHECK(not token.cancelled());
+    BOOST_CHECK(token.wait(0.01)); //full timeout elapsed
+    token.cancel();
+    BOOST_CHECK(token.cancelled());
+    BOOST_CHECK(not token.wait(10.0)); //returns right away
+}
+
+BOOST_AUTO_TEST_CASE(test_cancel_token_wait)
+{
+    gras::CancelToken token = gras::CancelToken::make();
+    boost::thread canceller(boost::bind(&sleep_then_cancel, token));
+    const gras::time_ticks_t t0 = gras::time_now();
+    BOOST_CHECK(not token.wait(10.0));
+    const double delta_time = double(gras::time_now()-t0)/gras::time_tps();
+    std::cout << "delta_time " << delta_time << std::endl;
+    BOOST_CHECK(delta_time < 5.0);
+    canceller.join();
+}
+
+#ifndef _WIN32
+BOOST_AUTO_TEST_CASE(test_cancel_token_wait_readable)
+{
+    int fds[2];
+    BOOST_REQUIRE(pipe(fds) == 0);
+    gras::CancelToken token = gras::CancelToken::make();
+
+    //nothing to read, times out
+    BOOST_CHECK(not token.wait_readable(fds[0], 0.01));
+
+    //something to read
+    const char byte = 0;
+    BOOST_CHECK(write(fds[1], &byte, 1) == 1);
+    BOOST_CHECK(token.wait_readable(fds[0], 0.01));
+    char out;
+    BOOST_CHECK(read(fds[0], &out, 1) == 1);
+
+    //blocks forever until cancelled by another thread
+    boost::thread canceller(boost::bind(&sleep_then_cancel, token));
+    BOOST_CHECK(not token.wait_readable(fds[0]));
+    BOOST_CHECK(token.cancelled());
+    canceller.join();
+
+    //the cancel fd stays readable
+    BOOST_CHECK(token.get_fd() != -1);
+    BOOST_CHECK(gras::CancelToken(token).wait_writable(fds[1], 0.0) == false);
+
+    close(fds[0]);
+    close(fds[1]);
+}
+#endif
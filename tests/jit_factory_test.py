@@ -171,5 +171,119 @@ GRAS_REGISTER_FACTORY0("/tests/my_foo_bar", FooBar)
 """
         gras.jit_factory(SOURCE, ["-O3", "-I"+gras_inc, "-I"+pmc_inc])
 
+    def test_jit_cache(self):
+        SOURCE = """
+#include <gras/block.hpp>
+#include <gras/factory.hpp>
+
+struct CachedFoo : gras::Block
+{
+    CachedFoo(void):
+        gras::Block("CachedFoo")
+    {
+    }
+
+    void work(const InputItems &, const OutputItems &)
+    {
+    }
+};
+
+GRAS_REGISTER_FACTORY0("/tests/my_cached_foo", CachedFoo)
+"""
+        import tempfile
+        import shutil
+        cache_dir = tempfile.mkdtemp()
+        os.environ['GRAS_JIT_CACHE'] = cache_dir
+        try:
+            gras.jit_factory(SOURCE, ["-O3", "-I"+gras_inc, "-I"+pmc_inc])
+            cached = [f for f in os.listdir(cache_dir) if f.endswith('.jit')]
+            self.assertEqual(len(cached), 1)
+            gras.make("/tests/my_cached_foo")
+
+            #a truncated entry is discarded and compiled again
+            entry = os.path.join(cache_dir, cached[0])
+            data = open(entry, 'rb').read()
+            open(entry, 'wb').write(data[:-len(data)//4])
+            gras.jit_factory(SOURCE, ["-O3", "-I"+gras_inc, "-I"+pmc_inc])
+            self.assertEqual(len(open(entry, 'rb').read()), len(data))
+        finally:
+            del os.environ['GRAS_JIT_CACHE']
+            shutil.rmtree(cache_dir)
+
+    def test_jit_cache_headers(self):
+        SOURCE = """
+#include <gras/block.hpp>
+#include <gras/factory.hpp>
+#include <cached_foo_path.h>
+
+struct CachedHeaderFoo : gras::Block
+{
+    CachedHeaderFoo(void):
+        gras::Block("CachedHeaderFoo")
+    {
+    }
+
+    void work(const InputItems &, const OutputItems &)
+    {
+    }
+};
+
+GRAS_REGISTER_FACTORY0(CACHED_FOO_PATH, CachedHeaderFoo)
+"""
+        import tempfile
+        import shutil
+        import time
+        cache_dir = tempfile.mkdtemp()
+        inc_dir = tempfile.mkdtemp()
+        header = os.path.join(inc_dir, 'cached_foo_path.h')
+        os.environ['GRAS_JIT_CACHE'] = cache_dir
+        try:
+            flags = ["-O3", "-I"+gras_inc, "-I"+pmc_inc, "-I"+inc_dir]
+            open(header, 'w').write('#define CACHED_FOO_PATH "/tests/my_cached_header_foo0"\n')
+            gras.jit_factory(SOURCE, flags)
+            gras.make("/tests/my_cached_header_foo0")
+
+            #the same source with a changed header must compile again
+            time.sleep(1.1)
+            open(header, 'w').write('#define CACHED_FOO_PATH "/tests/my_cached_header_foo1"\n')
+            gras.jit_factory(SOURCE, flags)
+            gras.make("/tests/my_cached_header_foo1")
+            #the entry now stamps the changed header
+            cached = [f for f in os.listdir(cache_dir) if f.endswith('.jit')]
+            self.assertEqual(len(cached), 1)
+        finally:
+            del os.environ['GRAS_JIT_CACHE']
+            shutil.rmtree(cache_dir)
+            shutil.rmtree(inc_dir)
+
+    def test_jit_factory_batch(self):
+        SOURCE = """
+#include <gras/block.hpp>
+#include <gras/factory.hpp>
+
+struct BatchFoo%d : gras::Block
+{
+    BatchFoo%d(void):
+        gras::Block("BatchFoo%d")
+    {
+    }
+
+    void work(const InputItems &, const OutputItems &)
+    {
+    }
+};
+
+GRAS_REGISTER_FACTORY0("/tests/my_batch_foo%d", BatchFoo%d)
+"""
+        flags = ["-O3", "-I"+gras_inc, "-I"+pmc_inc]
+        gras.jit_factory_batch([SOURCE.replace('%d', str(i)) for i in range(4)], flags)
+        for i in range(4): gras.make("/tests/my_batch_foo%d"%i)
+
+        #one bad source fails the batch and nothing is loaded
+        sources = [SOURCE.replace('%d', str(i)) for i in range(4, 6)]
+        sources.append("this is not c++")
+        self.assertRaises(Exception, gras.jit_factory_batch, sources, flags)
+        self.assertRaises(Exception, gras.make, "/tests/my_batch_foo4")
+
 if __name__ == '__main__':
     unittest.main()
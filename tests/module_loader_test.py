@@ -1,6 +1,7 @@
 # Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
 
 import unittest
+import os
 import gras
 
 class ModuleLoaderTest(unittest.TestCase):
@@ -13,5 +14,14 @@ class ModuleLoaderTest(unittest.TestCase):
         my_block = gras.make("/tests/my_block1")
         self.assertEqual(my_block.get_num(), 42)
 
+    def test_load_module_manifest(self):
+        manifest = os.environ['GRAS_MODULE_PATH'] + '.manifest'
+        paths = [line.strip() for line in open(manifest) if not line.startswith('#')]
+        self.assertTrue('/tests/my_block0' in paths)
+
+        #the module loads on demand for a path in its manifest
+        my_block = gras.make("/tests/my_block0")
+        self.assertEqual(my_block.get_num(), 42)
+
 if __name__ == '__main__':
     unittest.main()
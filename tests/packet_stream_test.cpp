@@ -0,0 +1,169 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#include <boost/test/unit_test.hpp>
+#include <stdexcept>
+#include <iostream>
+#include <vector>
+#include <cstring>
+
+#include <gras/block.hpp>
+#include <gras/top_block.hpp>
+#include <gras/buffer_queue.hpp>
+
+static const size_t NUM_RECORDS = 100;
+static const size_t OUTPUT_BUFFER_BYTES = 256;
+
+//! The payload of a record is its index repeated, with a varying length
+static std::vector<char> make_payload(const size_t index)
+{
+    return std::vector<char>((index*7)%200 + 1, char(index));
+}
+
+struct MyRecordSource : gras::Block
+{
+    MyRecordSource(void):
+        gras::Block("MyRecordSource"),
+        num_posted(0)
+    {
+        this->output_config(0).item_size = 1;
+    }
+
+    void work(const InputItems &, const OutputItems &)
+    {
+        //post until the buffer is full, the rest go into the next buffer
+        while (num_posted < NUM_RECORDS)
+        {
+            const std::vector<char> payload = make_payload(num_posted);
+            if (not this->post_output_record(0, &payload.front(), payload.size(), unsigned(num_posted))) return;
+            num_posted++;
+        }
+        this->mark_done();
+    }
+
+    //small buffers so that records fall on buffer boundaries
+    gras::BufferQueueSptr output_buffer_allocator(const size_t, const gras::SBufferConfig &config)
+    {
+        gras::SBufferConfig small_config = config;
+        small_config.length = OUTPUT_BUFFER_BYTES;
+        return gras::BufferQueue::make_pool(small_config, 4);
+    }
+
+    size_t num_posted;
+};
+
+struct MyRecordSink : gras::Block
+{
+    MyRecordSink(void):
+        gras::Block("MyRecordSink"),
+        num_truncated(0)
+    {
+        this->input_config(0).item_size = 1;
+        this->input_config(0).packet_stream = true;
+    }
+
+    void work(const InputItems &ins, const OutputItems &)
+    {
+        gras::PacketRecord record;
+        try
+        {
+            while (this->pop_input_record(0, record))
+            {
+                const char *data = reinterpret_cast<const char *>(record.data);
+                records.push_back(std::vector<char>(data, data + record.length));
+                metas.push_back(record.meta);
+            }
+        }
+        catch (const std::runtime_error &)
+        {
+            //skip over the bad bytes
+            num_truncated++;
+            this->consume(0, ins[0].size());
+        }
+    }
+
+    std::vector<std::vector<char> > records;
+    std::vector<unsigned> metas;
+    size_t num_truncated;
+};
+
+//! Produces a header that claims more bytes than follow it
+struct MyTruncatedSource : gras::Block
+{
+    MyTruncatedSource(void):
+        gras::Block("MyTruncatedSource")
+    {
+        this->output_config(0).item_size = 1;
+    }
+
+    void work(const InputItems &, const OutputItems &outs)
+    {
+        char *out = outs[0].cast<char *>();
+        const unsigned header[2] = {100, 0}; //length, meta
+        std::memcpy(out, header, sizeof(header));
+        std::memset(out + sizeof(header), 0, 8);
+        this->produce(0, sizeof(header) + 8);
+        this->mark_done();
+    }
+};
+
+BOOST_AUTO_TEST_CASE(test_packet_stream_records)
+{
+    MyRecordSource source;
+    MyRecordSink sink;
+    gras::TopBlock tb("Top");
+    tb.connect(source, 0, sink, 0);
+    tb.run();
+
+    //all records arrive whole and in order,
+    //including the records that did not fit in the previous buffer
+    BOOST_REQUIRE_EQUAL(sink.records.size(), NUM_RECORDS);
+    for (size_t i = 0; i < NUM_RECORDS; i++)
+    {
+        BOOST_CHECK(sink.records[i] == make_payload(i));
+        BOOST_CHECK_EQUAL(sink.metas[i], unsigned(i));
+    }
+    BOOST_CHECK_EQUAL(sink.num_truncated, size_t(0));
+}
+
+BOOST_AUTO_TEST_CASE(test_packet_stream_truncated)
+{
+    MyTruncatedSource source;
+    MyRecordSink sink;
+    gras::TopBlock tb("Top");
+    tb.connect(source, 0, sink, 0);
+    tb.run();
+
+    BOOST_CHECK_EQUAL(sink.records.size(), size_t(0));
+    BOOST_CHECK_EQUAL(sink.num_truncated, size_t(1));
+}
+
+BOOST_AUTO_TEST_CASE(test_packet_stream_record_too_large)
+{
+    //a record that can never fit in an output buffer is an error,
+    //rather than a record split across two buffers
+    struct MyLargeSource : MyRecordSource
+    {
+        void work(const InputItems &, const OutputItems &)
+        {
+            const std::vector<char> payload(OUTPUT_BUFFER_BYTES*2);
+            try
+            {
+                this->post_output_record(0, &payload.front(), payload.size());
+            }
+            catch (const std::invalid_argument &)
+            {
+                threw = true;
+            }
+            this->mark_done();
+        }
+        bool threw;
+    };
+
+    MyLargeSource source;
+    source.threw = false;
+    MyRecordSink sink;
+    gras::TopBlock tb("Top");
+    tb.connect(source, 0, sink, 0);
+    tb.run();
+    BOOST_CHECK(source.threw);
+}
@@ -70,6 +70,156 @@ class QueryTest(unittest.TestCase):
         #found the block we asked for
         self.assertTrue(block_id in stats_result['blocks'])
 
+    def test_metrics(self):
+        vec_source = TestUtils.VectorSource(numpy.uint32, [0, 9, 8, 7, 6])
+        vec_sink = TestUtils.VectorSink(numpy.uint32)
+        vec_sink.set_uid("test_metrics_sink")
+
+        self.tb.connect(vec_source, vec_sink)
+        self.tb.run()
+
+        #the metrics are text, so query with a json string
+        metrics = self.tb.query('{"path":"/metrics"}')
+        self.assertTrue('# TYPE gras_items_consumed counter' in metrics)
+        self.assertTrue('gras_items_consumed_total{block="test_metrics_sink",input="0"} 5' in metrics)
+        self.assertTrue(metrics.endswith('# EOF\n'))
+
+    def test_perf_counters(self):
+        vec_source = TestUtils.VectorSource(numpy.uint32, range(1000))
+        vec_sink = TestUtils.VectorSink(numpy.uint32)
+        vec_sink.set_uid("test_perf_counters_sink")
+
+        #the top block config reaches the blocks
+        self.tb.global_config().perf_counters = True
+        self.tb.connect(vec_source, vec_sink)
+        self.tb.run()
+
+        stats_result = self.tb.query(dict(path="/stats.json", blocks=["test_perf_counters_sink"]))
+        stats = stats_result['blocks']['test_perf_counters_sink']
+        self.assertEqual(stats['perf_enabled'], 1)
+        for key in ('perf_cycles', 'perf_instructions', 'perf_cache_misses', 'perf_branch_misses'):
+            self.assertTrue(key in stats)
+
+        #the counters are zero when perf_event_paranoid forbids them
+        if stats['perf_cycles'] > 0: self.assertTrue(stats['perf_instructions'] > 0)
+
+        metrics = self.tb.query('{"path":"/metrics"}')
+        for key in ('perf_cycles', 'perf_instructions', 'perf_cache_misses', 'perf_branch_misses'):
+            self.assertTrue('# TYPE gras_%s counter'%key in metrics)
+            self.assertTrue('gras_%s_total{block="test_perf_counters_sink"}'%key in metrics)
+
+    def test_perf_counters_disabled(self):
+        vec_source = TestUtils.VectorSource(numpy.uint32, [0, 9, 8, 7, 6])
+        vec_sink = TestUtils.VectorSink(numpy.uint32)
+        vec_sink.set_uid("test_perf_counters_disabled_sink")
+        self.tb.connect(vec_source, vec_sink)
+        self.tb.run()
+
+        stats_result = self.tb.query(dict(path="/stats.json", blocks=["test_perf_counters_disabled_sink"]))
+        stats = stats_result['blocks']['test_perf_counters_disabled_sink']
+        self.assertEqual(stats['perf_enabled'], 0)
+        self.assertEqual(stats['perf_cycles'], 0)
+
+    def test_trace(self):
+        null_source = TestUtils.NullSource(numpy.uint32)
+        null_sink = TestUtils.NullSink(numpy.uint32)
+        null_source.set_uid("test_trace_source")
+
+        self.tb.connect(null_source, null_sink)
+        self.tb.start()
+        trace = self.tb.query(dict(path="/trace.json", seconds=0.1))
+        self.tb.stop()
+        self.tb.wait()
+
+        #the work calls were recorded as begin/end pairs
+        work_events = [e for e in trace['traceEvents'] if e['name'] == 'work']
+        self.assertTrue(len(work_events) > 0)
+        self.assertTrue('test_trace_source' in [e['args']['block'] for e in work_events])
+
+    def test_bottleneck(self):
+        vec_source = TestUtils.VectorSource(numpy.uint32, [0, 9, 8, 7, 6])
+        vec_sink = TestUtils.VectorSink(numpy.uint32)
+        vec_sink.set_uid("test_bottleneck_sink")
+
+        self.tb.connect(vec_source, vec_sink)
+        self.tb.run()
+
+        result = self.tb.query(dict(path="/bottleneck.json"))
+        self.assertEqual(len(result['blocks']), 2)
+        for block in result['blocks']:
+            self.assertTrue(block['state'] in ('idle', 'compute_bound', 'backpressured', 'starved'))
+
+        #one path that ends in the sink and goes through both blocks
+        self.assertEqual(len(result['paths']), 1)
+        self.assertEqual(result['paths'][0]['sink'], "test_bottleneck_sink")
+        self.assertEqual(result['paths'][0]['num_blocks'], 2)
+
+    def test_query_server(self):
+        import json
+        import urllib2
+        vec_source = TestUtils.VectorSource(numpy.uint32, [0, 9, 8, 7, 6])
+        vec_sink = TestUtils.VectorSink(numpy.uint32)
+        vec_sink.set_uid("test_query_server_sink")
+
+        self.tb.connect(vec_source, vec_sink)
+        self.tb.run()
+
+        #listens on loopback by default
+        port = self.tb.start_query_server(0, "")
+        url = "http://127.0.0.1:%d"%port
+        blocks_result = json.loads(urllib2.urlopen(url + "/blocks.json").read())
+        self.assertTrue('test_query_server_sink' in blocks_result['blocks'])
+        stats_result = json.loads(urllib2.urlopen(url + "/stats.json?blocks=test_query_server_sink").read())
+        self.assertTrue('test_query_server_sink' in stats_result['blocks'])
+        self.tb.stop_query_server()
+
+    def test_query_server_events(self):
+        import json
+        import urllib2
+        vec_source = TestUtils.VectorSource(numpy.uint32, [0, 9, 8, 7, 6])
+        vec_sink = TestUtils.VectorSink(numpy.uint32)
+        vec_sink.set_uid("test_query_server_events_sink")
+
+        self.tb.connect(vec_source, vec_sink)
+        self.tb.run()
+
+        #listens on every address of the name, which the client also resolves
+        port = self.tb.start_query_server(0, "", "localhost")
+        response = urllib2.urlopen("http://localhost:%d/stats.events?blocks=test_query_server_events_sink&rate=20"%port)
+        def read_event():
+            while True:
+                line = response.readline()
+                if line.startswith('data: '): return json.loads(line[len('data: '):])
+
+        #the first event has all of the requested blocks
+        event = read_event()
+        self.assertTrue('test_query_server_events_sink' in event['blocks'])
+        self.assertEqual(event['blocks']['test_query_server_events_sink']['items_consumed'], [5])
+
+        #the flow graph is done, so later events have no changed blocks
+        event = read_event()
+        self.assertEqual(len(event['blocks']), 0)
+        response.close()
+        self.tb.stop_query_server()
+
+    def test_stats_since(self):
+        vec_source = TestUtils.VectorSource(numpy.uint32, [0, 9, 8, 7, 6])
+        vec_sink = TestUtils.VectorSink(numpy.uint32)
+        vec_sink.set_uid("test_stats_since_sink")
+
+        self.tb.connect(vec_source, vec_sink)
+        self.tb.run()
+
+        #a delta since before the stats were published has the block
+        stats_result = self.tb.query(dict(path="/stats.json", blocks=["test_stats_since_sink"]))
+        stats_time = stats_result['blocks']['test_stats_since_sink']['stats_time']
+        stats_result = self.tb.query(dict(path="/stats.json", blocks=["test_stats_since_sink"], since=stats_time-1))
+        self.assertTrue('test_stats_since_sink' in stats_result['blocks'])
+
+        #a delta since the last publish skips the block
+        stats_result = self.tb.query(dict(path="/stats.json", blocks=["test_stats_since_sink"], since=stats_time))
+        self.assertFalse('test_stats_since_sink' in stats_result['blocks'])
+
     def test_numeric_query(self):
         vec_source = TestUtils.VectorSource(numpy.uint32, [0, 9, 8, 7, 6])
         vec_sink = TestUtils.VectorSink(numpy.uint32)
@@ -74,3 +74,41 @@ BOOST_AUTO_TEST_CASE(test_time_tag_type)
     const gras::TimeTag &t1 = result.as<gras::TimeTag>();
     BOOST_CHECK(t0 == t1);
 }
+
+BOOST_AUTO_TEST_CASE(test_stream_tag_key_type)
+{
+    gras::StreamTag tag(PMC_M(std::string("rx_time")), PMC_M(long(42)));
+    BOOST_CHECK(tag.get_key_id() == gras::TagKey("rx_time"));
+    BOOST_CHECK(tag.get_key_id() != gras::TagKey("rx_rate"));
+    BOOST_CHECK(tag.get_key_id().key().eq(tag.key));
+    BOOST_CHECK_EQUAL(gras::TagKey().id, size_t(0));
+
+    //the interned key is restored on deserialize
+    PMCC result = loopback_test(PMC_M(tag));
+    BOOST_CHECK(result.as<gras::StreamTag>().get_key_id() == tag.get_key_id());
+}
+
+BOOST_AUTO_TEST_CASE(test_stream_tag_key_assigned)
+{
+    //a default constructed tag with an assigned key still matches by key
+    gras::StreamTag tag;
+    tag.key = PMC_M(std::string("rx_time"));
+    BOOST_CHECK(tag.get_key_id() == gras::TagKey("rx_time"));
+    BOOST_CHECK(tag.get_key_id() == gras::TagKey(tag.key));
+    BOOST_CHECK(gras::StreamTag().get_key_id() == gras::TagKey());
+}
+
+BOOST_AUTO_TEST_CASE(test_stream_tag_key_reassigned)
+{
+    //reassigning the key of a constructed tag changes its interned key
+    gras::StreamTag tag(PMC_M(std::string("rx_time")));
+    BOOST_CHECK(tag.get_key_id() == gras::TagKey("rx_time"));
+    tag.key = PMC_M(std::string("rx_rate"));
+    BOOST_CHECK(tag.get_key_id() == gras::TagKey("rx_rate"));
+    tag.key = PMCC();
+    BOOST_CHECK(tag.get_key_id() == gras::TagKey());
+
+    //copies carry the interned key with them
+    const gras::StreamTag copy = gras::StreamTag(PMC_M(std::string("rx_time")));
+    BOOST_CHECK(copy.get_key_id() == gras::TagKey("rx_time"));
+}
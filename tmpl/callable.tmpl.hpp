@@ -9,6 +9,7 @@
 #endif //_MSC_VER
 
 #include <gras/gras.hpp>
+#include <gras/call_future.hpp>
 #include <PMC/PMC.hpp>
 #include <boost/shared_ptr.hpp>
 #include <vector>
@@ -17,6 +18,9 @@
 namespace gras
 {
 
+class CallHandle;
+struct CallableRegistryEntry;
+
 /*!
  * The callable interface allows subclasses to export public methods,
  * but without actually exporting traditional library symbols.
@@ -31,6 +35,14 @@ namespace gras
  * Call a method on a instance of MyClass:
  * my_class->x("set_foo", new_foo_val);
  *
+ * Call a method without waiting on the call:
+ * gras::CallFuture f = my_class->call_async("get_foo");
+ * foo = f.get<Foo>();
+ *
+ * Resolve a call once and call it many times:
+ * gras::CallHandle set_foo = my_class->get_call_handle("set_foo");
+ * set_foo.x(new_foo_val);
+ *
  * Why x for the call method?
  *  - The "x" is short, one character of screen width.
  *  - The "x" looks like "*", which is commonly used.
@@ -50,6 +62,16 @@ public:
     //! Get a list of names for registered calls
     std::vector<std::string> get_registered_names(void) const;
 
+    /*!
+     * Get a handle to a registered call.
+     * The handle resolves the name once, so calls through the handle
+     * skip the registry lookup. When the argument and return types
+     * match the registered method exactly, calls also skip PMC boxing.
+     * Throws if the name is not found in the registry.
+     * The handle must not outlive this callable.
+     */
+    CallHandle get_call_handle(const std::string &name);
+
 protected:
     /*!
      * Unregister a previously registered call.
@@ -57,6 +79,16 @@ protected:
      */
     void unregister_call(const std::string &name);
 
+    /*!
+     * Publish a value for the registered call of the given name.
+     * Call handles read the last published value with read(),
+     * without calling into this callable or waiting on its thread.
+     * A block would publish the value behind a getter
+     * in work() or in the setter that changes it.
+     */
+    template <typename ValueType>
+    void publish_call(const std::string &name, const ValueType &value);
+
     /*******************************************************************
      * Register API - don't look here, template magic, not helpful
      ******************************************************************/
@@ -80,18 +112,72 @@ public:
     template <$expand('typename A%d', $NARGS)>
     void x(const std::string &name, $expand('const A%d &', $NARGS));
 
+    #end for
+    /*******************************************************************
+     * Async call API - returns a future instead of waiting on the call
+     ******************************************************************/
+public:
+    #for $NARGS in range($MAX_ARGS)
+    template <$expand('typename A%d', $NARGS)>
+    CallFuture call_async(const std::string &name, $expand('const A%d &', $NARGS));
+
     #end for
     /*******************************************************************
      * Private registration hooks
      ******************************************************************/
 protected:
     void _register_call(const std::string &, void *);
+    void _publish_call(const std::string &, const PMCC &);
 public:
     virtual PMCC _handle_call(const std::string &, const PMCC &);
+    virtual CallFuture _handle_call_async(const std::string &, const PMCC &);
+    virtual void _handle_call_typed(CallableRegistryEntry &, const void *const *, void *);
 private:
     boost::shared_ptr<void> _call_registry;
 };
 
+/*!
+ * A call handle is a registered call of a callable, resolved by name once.
+ * Calls through the handle have the same semantics as Callable::x().
+ * Blocks still perform the call in the block's thread context.
+ */
+class GRAS_API CallHandle
+{
+public:
+
+    //! Create a null handle
+    CallHandle(void);
+
+    //! Get the name of the call
+    const std::string &name(void) const;
+
+    /*!
+     * Read the last value published for this call.
+     * This does not call into the callable and does not block,
+     * so it is safe to read at high rates from any thread.
+     * Throws if the callable never published a value for this call.
+     */
+    template <typename ReturnType>
+    ReturnType read(void) const;
+
+    /*******************************************************************
+     * Call API - don't look here, template magic, not helpful
+     ******************************************************************/
+    #for $NARGS in range($MAX_ARGS)
+    template <typename ReturnType, $expand('typename A%d', $NARGS)>
+    ReturnType x($expand('const A%d &', $NARGS)) const;
+
+    template <$expand('typename A%d', $NARGS)>
+    void x($expand('const A%d &', $NARGS)) const;
+
+    #end for
+private:
+    friend class Callable;
+    Callable *_callable;
+    std::string _name;
+    boost::shared_ptr<CallableRegistryEntry> _entry;
+};
+
 } //namespace gras
 
 #include <gras/detail/callable.hpp>
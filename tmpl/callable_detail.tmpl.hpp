@@ -4,6 +4,9 @@
 #define INCLUDED_GRAS_DETAIL_CALLABLE_HPP
 
 #include <PMC/Containers.hpp> //PMCList
+#include <boost/optional.hpp>
+#include <typeinfo>
+#include <stdexcept>
 
 namespace gras
 {
@@ -17,6 +20,19 @@ struct GRAS_API CallableRegistryEntry
     virtual ~CallableRegistryEntry(void);
     virtual PMCC call(const PMCC &args) = 0;
     void arg_check(const PMCList &args, const size_t nargs);
+
+    //! The signature of the method as a function pointer type
+    virtual const std::type_info &signature(void) const = 0;
+
+    /*!
+     * Call the method with typed arguments and without PMC boxing.
+     * The arguments are pointers to values of the exact signature types,
+     * and the return value is stored into a boost::optional<ReturnType>.
+     */
+    virtual void call_typed(const void *const *args, void *ret) = 0;
+
+    //! The last value published for this call, read and written atomically
+    boost::shared_ptr<const PMCC> published;
 };
 
 #for $NARGS in range($MAX_ARGS)
@@ -35,6 +51,14 @@ struct CallableRegistryEntryImpl$(NARGS) : CallableRegistryEntry
         this->arg_check(a, $NARGS);
         return PMC_M((_obj->*_fcn)($expand('a[%d].safe_as<A%d>()', $NARGS)));
     }
+    const std::type_info &signature(void) const
+    {
+        return typeid(ReturnType(*)($expand('A%d', $NARGS)));
+    }
+    void call_typed(const void *const *args, void *ret)
+    {
+        *reinterpret_cast<boost::optional<ReturnType> *>(ret) = (_obj->*_fcn)($expand('*reinterpret_cast<const A%d *>(args[%d])', $NARGS));
+    }
     ClassType *_obj; Fcn _fcn;
 };
 
@@ -58,6 +82,14 @@ struct CallableRegistryEntryImplVoid$(NARGS) : CallableRegistryEntry
         this->arg_check(a, $NARGS);
         (_obj->*_fcn)($expand('a[%d].safe_as<A%d>()', $NARGS)); return PMCC();
     }
+    const std::type_info &signature(void) const
+    {
+        return typeid(void(*)($expand('A%d', $NARGS)));
+    }
+    void call_typed(const void *const *args, void *)
+    {
+        (_obj->*_fcn)($expand('*reinterpret_cast<const A%d *>(args[%d])', $NARGS));
+    }
     ClassType *_obj; Fcn _fcn;
 };
 
@@ -95,6 +127,77 @@ void Callable::x(const std::string &name, $expand('const A%d &a%d', $NARGS))
     _handle_call(name, PMC_M(args));
 }
 
+#end for
+#for $NARGS in range($MAX_ARGS)
+/***********************************************************************
+ * Async call implementations with $NARGS args
+ **********************************************************************/
+template <$expand('typename A%d', $NARGS)>
+CallFuture Callable::call_async(const std::string &name, $expand('const A%d &a%d', $NARGS))
+{
+    PMCList args($NARGS);
+    #for $i in range($NARGS):
+    args[$i] = PMC_M(a$i);
+    #end for
+    return _handle_call_async(name, PMC_M(args));
+}
+
+#end for
+/***********************************************************************
+ * Published values for call handles
+ **********************************************************************/
+template <typename ValueType>
+void Callable::publish_call(const std::string &name, const ValueType &value)
+{
+    _publish_call(name, PMC_M(value));
+}
+
+template <typename ReturnType>
+ReturnType CallHandle::read(void) const
+{
+    const boost::shared_ptr<const PMCC> published = boost::atomic_load(&_entry->published);
+    if (not published) throw std::runtime_error("CallHandle - no value published for call: " + _name);
+    return published->safe_as<ReturnType>();
+}
+
+#for $NARGS in range($MAX_ARGS)
+/***********************************************************************
+ * Call handle implementations with $NARGS args
+ **********************************************************************/
+template <typename ReturnType, $expand('typename A%d', $NARGS)>
+ReturnType CallHandle::x($expand('const A%d &a%d', $NARGS)) const
+{
+    if (_entry->signature() == typeid(ReturnType(*)($expand('A%d', $NARGS))))
+    {
+        const void *args[$NARGS+1] = {$expand('&a%d', $NARGS)};
+        boost::optional<ReturnType> r;
+        _callable->_handle_call_typed(*_entry, args, &r);
+        return r.get();
+    }
+    PMCList args($NARGS);
+    #for $i in range($NARGS):
+    args[$i] = PMC_M(a$i);
+    #end for
+    PMCC r = _callable->_handle_call(_name, PMC_M(args));
+    return r.safe_as<ReturnType>();
+}
+
+template <$expand('typename A%d', $NARGS)>
+void CallHandle::x($expand('const A%d &a%d', $NARGS)) const
+{
+    if (_entry->signature() == typeid(void(*)($expand('A%d', $NARGS))))
+    {
+        const void *args[$NARGS+1] = {$expand('&a%d', $NARGS)};
+        _callable->_handle_call_typed(*_entry, args, NULL);
+        return;
+    }
+    PMCList args($NARGS);
+    #for $i in range($NARGS):
+    args[$i] = PMC_M(a$i);
+    #end for
+    _callable->_handle_call(_name, PMC_M(args));
+}
+
 #end for
 } //namespace gras
 
@@ -5,6 +5,7 @@
 
 #include <gras/gras.hpp>
 #include <gras/element.hpp>
+#include <gras/call_future.hpp>
 #include <PMC/PMC.hpp>
 #include <vector>
 #include <string>
@@ -24,11 +25,42 @@ namespace gras
  * Users may leave this empty unless headers
  * are installed into non-standard directories.
  *
+ * Compiled bitcode is cached on disk, keyed by a hash of the source,
+ * the flags, the compiler version, and the GRAS version,
+ * so that loading the same source again skips the compiler.
+ * The cache lives in the GRAS_JIT_CACHE directory when set,
+ * and otherwise in ~/.gras/jit_cache. Set GRAS_JIT_CACHE
+ * to an empty string to disable the cache.
+ *
  * \param source C++ source code in a string
  * \param flags optional compiler flags
  */
 GRAS_API void jit_factory(const std::string &source, const std::vector<std::string> &flags);
 
+/*!
+ * Run the just in time factory in a background thread.
+ * The calling thread can go on with other setup while clang compiles;
+ * wait on the future before making elements from the compiled source.
+ * Errors from the compilation are thrown by the future's get().
+ *
+ * \param source C++ source code in a string
+ * \param flags optional compiler flags
+ * \return a future that completes when the factory is loaded
+ */
+GRAS_API CallFuture jit_factory_async(const std::string &source, const std::vector<std::string> &flags);
+
+/*!
+ * Run the just in time factory on many sources at once.
+ * The sources compile in parallel clang processes,
+ * and the compiled sources load into the factory together.
+ * When any of the sources fails to compile, nothing is loaded,
+ * and the error has the compiler diagnostics of every failed source.
+ *
+ * \param sources a list of C++ source code strings
+ * \param flags optional compiler flags for all of the sources
+ */
+GRAS_API void jit_factory_batch(const std::vector<std::string> &sources, const std::vector<std::string> &flags);
+
 /***********************************************************************
  * Register API - don't look here, template magic, not helpful
  * Example register a factory function: